@@ -22,4 +22,13 @@ int getProcessID(unsigned int iter);
  */
 process_info_t getProcessInfo(int pid);
 
+/**
+ * @ingroup Process Info
+ *
+ * @brief Returns the process ID of the calling process, read from its process data page without a syscall
+ * @param None
+ * @return The process ID of the calling process
+ */
+int getCurrentProcessID();
+
 #endif //_GET_PROCESS_INFO_API_DEF_H_
@@ -0,0 +1,43 @@
+#ifndef _PROCESS_IPC_API_DEF_H_
+#define _PROCESS_IPC_API_DEF_H_
+#include <syscall/syscall.h>
+#include <syscall/syscall_ipc.h>
+
+/**
+ * @ingroup IPC
+ *
+ * @brief Send a message to the process (or thread) with the PID given and sleep untill it replies
+ * @param pid The process to call, msg The message to send, overwritten with the reply
+ * @return 0 once the reply is in msg, IPC_ERROR_NO_PROCESS or IPC_ERROR_EXITED if the process exited before replying
+ */
+int ipcCall(int pid, ipc_message_t* msg);
+
+/**
+ * @ingroup IPC
+ *
+ * @brief Sleep untill a process calls this one, taking the oldest call if any are already waiting
+ * @param msg Where the message is copied
+ * @return The PID of the caller, which sleeps untill it is replied to
+ */
+int ipcReceive(ipc_message_t* msg);
+
+/**
+ * @ingroup IPC
+ *
+ * @brief Reply to a call returned by ipcReceive, waking the caller
+ * @param pid The PID of the caller, msg The reply
+ * @return 0, or IPC_ERROR_NOT_CALLING if the process isn't waiting on a reply from this one
+ */
+int ipcReply(int pid, ipc_message_t* msg);
+
+/**
+ * @ingroup IPC
+ *
+ * @brief Reply to a call and receive the next one in a single syscall, the loop a server should run in. If nobody else
+ * is calling the CPU goes straight back to the caller
+ * @param pid The PID of the caller, msg The reply, overwritten with the next message
+ * @return The PID of the next caller, or IPC_ERROR_NOT_CALLING (without receiving) if the reply couldn't be made
+ */
+int ipcReplyReceive(int pid, ipc_message_t* msg);
+
+#endif //_PROCESS_IPC_API_DEF_H_
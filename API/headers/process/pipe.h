@@ -0,0 +1,42 @@
+#ifndef _PROCESS_PIPE_API_DEF_H_
+#define _PROCESS_PIPE_API_DEF_H_
+#include <syscall/syscall.h>
+#include <syscall/syscall_handles.h>
+
+/**
+ * @ingroup Pipes
+ *
+ * @brief Create a pipe, a byte stream through the kernel between whoever holds its two ends
+ * @param handles Set to the handle of the read end (handles[0]) and the write end (handles[1]), flags HANDLE_INHERIT
+ * to pass both handles on to every process this one runs
+ * @return 0, HANDLE_ERROR_TABLE_FULL or HANDLE_ERROR_NO_MEMORY
+ */
+int pipeCreate(int* handles, unsigned int flags);
+
+/**
+ * @ingroup Pipes
+ *
+ * @brief Read up to length bytes from a handle, sleeping untill there is something to read
+ * @param flags HANDLE_NONBLOCK to return HANDLE_ERROR_WOULD_BLOCK instead of sleeping
+ * @return The number of bytes read, 0 once every write end is closed and everything has been read, or an error
+ */
+int handleRead(int handle, void* buffer, unsigned int length, unsigned int flags);
+
+/**
+ * @ingroup Pipes
+ *
+ * @brief Write length bytes to a handle, sleeping whenever the pipe is full
+ * @param flags HANDLE_NONBLOCK to only write what fits without sleeping
+ * @return The number of bytes written, HANDLE_ERROR_CLOSED if nothing will read them or another error
+ */
+int handleWrite(int handle, const void* buffer, unsigned int length, unsigned int flags);
+
+/**
+ * @ingroup Pipes
+ *
+ * @brief Close a handle, the pipe is freed once both of its ends are closed everywhere
+ * @return 0 or HANDLE_ERROR_BAD
+ */
+int handleClose(int handle);
+
+#endif //_PROCESS_PIPE_API_DEF_H_
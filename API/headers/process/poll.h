@@ -0,0 +1,37 @@
+#ifndef _PROCESS_POLL_API_DEF_H_
+#define _PROCESS_POLL_API_DEF_H_
+#include <syscall/syscall.h>
+#include <syscall/syscall_poll.h>
+
+/**
+ * @ingroup Poll
+ *
+ * @brief Register interest in an event source so pollWait reports it
+ * @param source One of the POLL_SOURCE_ sources, id is the handle for POLL_SOURCE_HANDLE and the number of clock ticks
+ * between expiries for POLL_SOURCE_TIMER
+ * @param events The POLL_ events to report (timers always report POLL_EXPIRED and rings POLL_COMPLETED)
+ * @param userData Reported along with the events
+ * @return The registration, to be passed to pollRemove, or a POLL_ERROR
+ */
+int pollAdd(unsigned int source, unsigned int id, unsigned int events, unsigned int userData);
+
+/**
+ * @ingroup Poll
+ *
+ * @brief Remove a registration, registrations on a handle are also removed when it is closed
+ * @return 0 or POLL_ERROR_BAD
+ */
+int pollRemove(int registration);
+
+/**
+ * @ingroup Poll
+ *
+ * @brief Sleep untill one or more of the registered sources are ready. Each source is reported once every time it
+ * becomes ready, so it should be drained before waiting again
+ * @param events Filled in with up to max ready sources
+ * @param ticks The most clock ticks to wait for, 0 waits forever
+ * @return The number of ready sources, 0 if it timed out
+ */
+int pollWait(poll_event_t* events, unsigned int max, unsigned long ticks);
+
+#endif //_PROCESS_POLL_API_DEF_H_
@@ -21,6 +21,58 @@ extern unsigned char postboxHasNext();
  */
 extern process_message postboxGetNext();
 
+/**
+ * @ingroup Postbox API
+ *
+ * @brief Read and remove up to max messages from the postbox in a single syscall, oldest first
+ * @param buffer The array the messages are copied into, max The number of messages it can hold
+ * @return The number of messages copied (0 if the postbox was empty)
+ */
+extern unsigned int postboxGetBatch(process_message* buffer, unsigned int max);
+
+/**
+ * @ingroup Postbox API
+ *
+ * @brief Sleep untill a message arrives in the postbox (returning straight away if one is already waiting)
+ * @param timeout The most clock ticks to wait for, 0 waits forever
+ * @return 1 if a message is waiting, 0 if the wait timed out
+ */
+extern unsigned char postboxWait(unsigned long timeout);
+
+/**
+ * @ingroup Postbox API
+ *
+ * @brief Send a copy of the message to every process whose postbox flags have the event bit given set
+ * @param msg The message to send (from_PID is filled in by the kernel), bit Has to be BROADCAST_BIT, the other
+ * events are only raised by the kernel
+ * @return 0 or POSTBOX_ERROR_BAD_EVENT
+ */
+extern int postboxBroadcast(process_message* msg, uint32_t bit);
+
+/**
+ * @ingroup Postbox API
+ *
+ * @brief Send a message to the process with the PID given, optionally moving pages of memory to it without copying
+ * them. The pages are unmapped from this process straight away and mapped into the receiver when it reads the message,
+ * with messageAdditionalData pointing at them and grantPages set to how many there are
+ * @param pid The process to send to, msg The message (from_PID is filled in by the kernel), address The page aligned
+ * start of the pages to grant, pages The number of pages to grant (0 for none)
+ * @return 0, POSTBOX_ERROR_NO_PROCESS, POSTBOX_ERROR_BAD_GRANT if the pages aren't memory of this process or
+ * POSTBOX_ERROR_THREADED_GRANT if pages are granted while this process has other threads running
+ */
+extern int postboxSend(int pid, process_message* msg, void* address, unsigned int pages);
+
+/**
+ * @ingroup Postbox API
+ *
+ * @brief Set how many messages the postbox holds and what happens to messages sent to it once it is full. Every
+ * postbox starts out holding POSTBOX_DEFAULT_LIMIT messages with POSTBOX_DROP_NEWEST
+ * @param limit The most messages held (0 for the default, at most POSTBOX_MAX_LIMIT), policy One of the POSTBOX_
+ * policies
+ * @return None
+ */
+extern void postboxSetLimit(unsigned int limit, unsigned char policy);
+
 /**
  * @ingroup Postbox API
  *
@@ -0,0 +1,57 @@
+#ifndef _PROCESS_THREAD_API_DEF_H_
+#define _PROCESS_THREAD_API_DEF_H_
+#include <syscall/syscall.h>
+
+/**
+ * The TLS block of a thread, the TLS segment (fs) of each thread is based at its own block. The first field points
+ * back at the block so it can be found with a single read of fs:0
+ */
+typedef struct threadBlock {
+	struct threadBlock* self;
+
+	/**
+	 * The thread specific value (threadSetSpecific)
+	 */
+	void* value;
+} thread_block_t;
+
+/**
+ * The function a thread runs, the thread exits with the value it returns
+ */
+typedef int (*thread_entry_t)(void* argument);
+
+/**
+ * @ingroup Threads
+ *
+ * @brief Start entry(argument) on a new thread sharing the memory, terminal, execution directory and postbox of this process
+ * @param stack Memory for the thread to use as its stack, its TLS block is placed at the top of it. It has to stay valid untill the thread exits
+ * @param stackSize The size of stack in bytes
+ * @return The ID of the new thread, which can be passed to threadJoin
+ */
+int threadCreate(thread_entry_t entry, void* argument, void* stack, unsigned long stackSize);
+
+/**
+ * @ingroup Threads
+ *
+ * @brief Sleeps the calling thread untill the thread given exits
+ * @return The value the thread exited with, or -1 if there is no thread with that ID
+ */
+int threadJoin(int id);
+
+/**
+ * @ingroup Threads
+ *
+ * @brief Ends the calling thread, the rest of the process keeps running
+ * @param value The value returned to threadJoin
+ */
+void threadExit(int value);
+
+/**
+ * @ingroup Threads
+ *
+ * @brief Set / get the value stored in the TLS block of the calling thread
+ */
+void threadSetSpecific(void* value);
+void* threadGetSpecific();
+
+#endif //_PROCESS_THREAD_API_DEF_H_
@@ -0,0 +1,14 @@
+#ifndef _PROCESS_WAIT_API_DEF_H_
+#define _PROCESS_WAIT_API_DEF_H_
+#include <syscall/syscall.h>
+
+/**
+ * @ingroup Process Info
+ *
+ * @brief Sleeps the calling process untill the process with the given PID exits
+ * @param The process ID to wait on (e.g. one returned by systemRunNewProcess)
+ * @return The value the process exited with, or -1 if there is no process with that PID
+ */
+int waitProcess(int pid);
+
+#endif //_PROCESS_WAIT_API_DEF_H_
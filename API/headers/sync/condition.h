@@ -0,0 +1,41 @@
+#ifndef _SYNC_CONDITION_API_DEF_H_
+#define _SYNC_CONDITION_API_DEF_H_
+#include <sync/mutex.h>
+
+/**
+ * A condition variable built on a futex. sequence changes on every signal so a waiter can't miss one between
+ * unlocking the mutex and sleeping, waiters lets signals skip the syscall when nobody is waiting
+ */
+typedef struct {
+	volatile uint32_t sequence;
+	volatile uint32_t waiters;
+} condition_t;
+
+#define CONDITION_INIT { 0, 0 }
+
+/**
+ * @ingroup Synchronisation
+ *
+ * @brief Set up a condition variable with no waiters
+ */
+void conditionInit(condition_t* condition);
+
+/**
+ * @ingroup Synchronisation
+ *
+ * @brief Release the mutex and sleep untill the condition is signalled, the mutex is held again when this returns.
+ * Wakeups can be spurious so the caller should check what it is waiting for in a loop
+ * @param timeout The most clock ticks to wait for, 0 waits for as long as it takes
+ * @return 0 if the timeout ran out, 1 otherwise
+ */
+unsigned char conditionWait(condition_t* condition, mutex_t* mutex, unsigned long timeout);
+
+/**
+ * @ingroup Synchronisation
+ *
+ * @brief Wake one / every thread waiting on the condition
+ */
+void conditionSignal(condition_t* condition);
+void conditionBroadcast(condition_t* condition);
+
+#endif //_SYNC_CONDITION_API_DEF_H_
@@ -0,0 +1,43 @@
+#ifndef _SYNC_FUTEX_API_DEF_H_
+#define _SYNC_FUTEX_API_DEF_H_
+#include <syscall/syscall.h>
+#include <syscall/syscall_futex.h>
+#include <types/stdint.h>
+
+/**
+ * Atomic operations on the 32 bit words futexes are built from. Each returns the value the word held before
+ */
+static inline uint32_t syncCompareExchange(volatile uint32_t* word, uint32_t expected, uint32_t replacement) {
+	uint32_t previous;
+	__asm__ volatile("lock cmpxchgl %2, %1" : "=a" (previous), "+m" (*word) : "r" (replacement), "0" (expected) : "memory");
+	return previous;
+}
+
+static inline uint32_t syncExchange(volatile uint32_t* word, uint32_t value) {
+	__asm__ volatile("xchgl %0, %1" : "+r" (value), "+m" (*word) : : "memory");
+	return value;
+}
+
+static inline uint32_t syncFetchAdd(volatile uint32_t* word, uint32_t value) {
+	__asm__ volatile("lock xaddl %0, %1" : "+r" (value), "+m" (*word) : : "memory");
+	return value;
+}
+
+/**
+ * @ingroup Synchronisation
+ *
+ * @brief Sleep while the word at address holds expected, untill futexWake is called on it
+ * @param timeout The most clock ticks to sleep for, 0 sleeps for as long as it takes
+ * @return FUTEX_WOKEN, FUTEX_VALUE_CHANGED if the word no longer held expected, FUTEX_TIMED_OUT or FUTEX_BAD_ADDRESS
+ */
+int futexWait(volatile uint32_t* address, uint32_t expected, unsigned long timeout);
+
+/**
+ * @ingroup Synchronisation
+ *
+ * @brief Wake up to count threads sleeping in futexWait on address (FUTEX_WAKE_ALL for all of them)
+ * @return The number of threads woken
+ */
+int futexWake(volatile uint32_t* address, uint32_t count);
+
+#endif //_SYNC_FUTEX_API_DEF_H_
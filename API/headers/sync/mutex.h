@@ -0,0 +1,44 @@
+#ifndef _SYNC_MUTEX_API_DEF_H_
+#define _SYNC_MUTEX_API_DEF_H_
+#include <sync/futex.h>
+
+/**
+ * A mutex built on a futex. state is 0 when unlocked, 1 when locked and 2 when locked with threads (possibly) waiting,
+ * only locking a contended mutex or unlocking one with waiters makes a syscall
+ */
+typedef struct {
+	volatile uint32_t state;
+} mutex_t;
+
+#define MUTEX_INIT { 0 }
+
+/**
+ * @ingroup Synchronisation
+ *
+ * @brief Set up a mutex in the unlocked state
+ */
+void mutexInit(mutex_t* mutex);
+
+/**
+ * @ingroup Synchronisation
+ *
+ * @brief Take the mutex, sleeping untill it is free
+ */
+void mutexLock(mutex_t* mutex);
+
+/**
+ * @ingroup Synchronisation
+ *
+ * @brief Take the mutex only if it is free
+ * @return 1 if the mutex was taken, 0 otherwise
+ */
+unsigned char mutexTryLock(mutex_t* mutex);
+
+/**
+ * @ingroup Synchronisation
+ *
+ * @brief Release the mutex, waking a thread waiting for it if there is one
+ */
+void mutexUnlock(mutex_t* mutex);
+
+#endif //_SYNC_MUTEX_API_DEF_H_
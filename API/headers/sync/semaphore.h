@@ -0,0 +1,37 @@
+#ifndef _SYNC_SEMAPHORE_API_DEF_H_
+#define _SYNC_SEMAPHORE_API_DEF_H_
+#include <sync/futex.h>
+
+/**
+ * A counting semaphore built on a futex. Waiting while the count is above 0 and posting while nobody waits never
+ * enter the kernel
+ */
+typedef struct {
+	volatile uint32_t count;
+	volatile uint32_t waiters;
+} semaphore_t;
+
+/**
+ * @ingroup Synchronisation
+ *
+ * @brief Set up a semaphore with the count given
+ */
+void semaphoreInit(semaphore_t* semaphore, uint32_t count);
+
+/**
+ * @ingroup Synchronisation
+ *
+ * @brief Wait for the count to be above 0 and take one from it
+ * @param timeout The most clock ticks to wait for, 0 waits for as long as it takes
+ * @return 1 if the count was taken, 0 if the timeout ran out first
+ */
+unsigned char semaphoreWait(semaphore_t* semaphore, unsigned long timeout);
+
+/**
+ * @ingroup Synchronisation
+ *
+ * @brief Add one to the count, waking a waiting thread if there is one
+ */
+void semaphorePost(semaphore_t* semaphore);
+
+#endif //_SYNC_SEMAPHORE_API_DEF_H_
@@ -0,0 +1,40 @@
+#ifndef _SYSCALL_RING_API_DEF_H_
+#define _SYSCALL_RING_API_DEF_H_
+#include <syscall/syscall.h>
+#include <syscall/syscall_ring.h>
+
+/**
+ * @ingroup Syscall Ring
+ *
+ * @brief Register ring as the syscall ring of this process (0 removes it). The ring is emptied first
+ * @param ring The ring to use, it has to stay valid for as long as it is registered
+ * @param flags SYSCALL_RING_POLL to have the kernel service the ring on every tick without syscallRingEnter
+ * @return None
+ */
+void syscallRingSetup(syscall_ring_t* ring, uint32_t flags);
+
+/**
+ * @ingroup Syscall Ring
+ *
+ * @brief Queue up an operation on the ring (One of the SYSCALL_RING_ operations)
+ * @return 1 if it was queued, 0 if the ring is full
+ */
+unsigned char syscallRingSubmit(syscall_ring_t* ring, uint32_t opcode, uint32_t userData, MEM_LOC p1, MEM_LOC p2, MEM_LOC p3, MEM_LOC p4);
+
+/**
+ * @ingroup Syscall Ring
+ *
+ * @brief Have the kernel carry out every operation queued on the registered ring in one syscall
+ * @return The number of operations carried out
+ */
+unsigned int syscallRingEnter();
+
+/**
+ * @ingroup Syscall Ring
+ *
+ * @brief Take the next completion off the ring
+ * @return 1 if a completion was copied to dest, 0 if there are none
+ */
+unsigned char syscallRingComplete(syscall_ring_t* ring, syscall_ring_completion_t* dest);
+
+#endif //_SYSCALL_RING_API_DEF_H_
@@ -9,28 +9,56 @@
 #define DECL_SYSCALL4(fn,p1,p2,p3,p4) MEM_LOC syscall_##fn(p1,p2,p3,p4);
 #define DECL_SYSCALL5(fn,p1,p2,p3,p4,p5) MEM_LOC syscall_##fn(p1,p2,p3,p4,p5);
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Make syscall num with up to five parameters through int $127 / through the fast entry (sysenter) and return its
+ * result. The fast entry only works if the kernel reports it available, syscallMake picks whichever is best
+ */
+MEM_LOC syscallInterrupt(MEM_LOC num, MEM_LOC p1, MEM_LOC p2, MEM_LOC p3, MEM_LOC p4, MEM_LOC p5);
+MEM_LOC syscallFastEntry(MEM_LOC num, MEM_LOC p1, MEM_LOC p2, MEM_LOC p3, MEM_LOC p4, MEM_LOC p5);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * Returns 1 if the kernel can take syscalls through the fast entry, asking the kernel the first time it is called
+ */
+unsigned char syscallFastAvailable();
+
+MEM_LOC syscallMake(MEM_LOC num, MEM_LOC p1, MEM_LOC p2, MEM_LOC p3, MEM_LOC p4, MEM_LOC p5);
+
 #define DEFN_SYSCALL0(fn, num) \
 	MEM_LOC syscall_##fn() \
 	{ \
-	 MEM_LOC a; \
-	 asm volatile("int $127" : "=a" (a) : "0" (num)); \
-	 return a; \
+	 return syscallMake(num, 0, 0, 0, 0, 0); \
 	}
 
 #define DEFN_SYSCALL1(fn, num, P1) \
 	MEM_LOC syscall_##fn(P1 p1) \
 	{ \
-	 MEM_LOC a; \
-	 asm volatile("int $127" : "=a" (a) : "0" (num), "b" ((int)p1)); \
-	 return a; \
+	 return syscallMake(num, (MEM_LOC) p1, 0, 0, 0, 0); \
 	}
 
 #define DEFN_SYSCALL2(fn, num, P1, P2) \
 	MEM_LOC syscall_##fn(P1 p1, P2 p2) \
 	{ \
-	 MEM_LOC a; \
-	 asm volatile("int $127" : "=a" (a) : "0" (num), "b" ((int)p1), "c" ((int)p2)); \
-	 return a; \
+	 return syscallMake(num, (MEM_LOC) p1, (MEM_LOC) p2, 0, 0, 0); \
+	}
+
+#define DEFN_SYSCALL3(fn, num, P1, P2, P3) \
+	MEM_LOC syscall_##fn(P1 p1, P2 p2, P3 p3) \
+	{ \
+	 return syscallMake(num, (MEM_LOC) p1, (MEM_LOC) p2, (MEM_LOC) p3, 0, 0); \
+	}
+
+#define DEFN_SYSCALL4(fn, num, P1, P2, P3, P4) \
+	MEM_LOC syscall_##fn(P1 p1, P2 p2, P3 p3, P4 p4) \
+	{ \
+	 return syscallMake(num, (MEM_LOC) p1, (MEM_LOC) p2, (MEM_LOC) p3, (MEM_LOC) p4, 0); \
 	}
 
 
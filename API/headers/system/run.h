@@ -1,6 +1,17 @@
 #ifndef _SYSTEM_API_RUN_NEW_PROCESS_
 #define _SYSTEM_API_RUN_NEW_PROCESS_
+#include <syscall/syscall_handles.h>
 
-void systemRunNewProcess(const char* Filename);
+/**
+ * Ask the kernel to run a new application, returns the PID of the new process or -1 if the file given could not be
+ * found or is not an executable
+ */
+int systemRunNewProcess(const char* Filename);
+
+/**
+ * systemRunNewProcess with the handles given (see process/pipe.h) as the input and output of the new process, HANDLE_NONE
+ * leaves either alone. Whatever the process prints goes to its output handle instead of the terminal
+ */
+int systemRunRedirected(const char* Filename, int stdinHandle, int stdoutHandle);
 
 #endif //_SYSTEM_API_RUN_NEW_PROCESS_
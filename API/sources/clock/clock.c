@@ -1,12 +1,13 @@
 #include <clock/clock.h>
+#include <system/kernel_data.h>
 
-DEFN_SYSCALL0(clocks_per_second, 10);
-DEFN_SYSCALL0(get_clock, 11);
+//The clock is read straight off the kernel data page, without entering the kernel
+static const kernel_data_page_t* const kernelData = (const kernel_data_page_t*) KERNEL_DATA_PAGE_ADDRESS;
 
 unsigned long getClocksPerSecond() {
-	return syscall_clocks_per_second();
+	return kernelData->ticksPerSecond;
 }
 
 unsigned long clock() {
-	return syscall_get_clock();
+	return kernelData->ticks;
 }
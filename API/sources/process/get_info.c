@@ -1,5 +1,6 @@
 #include <process/get_info.h>
 #include <common.h>
+#include <system/kernel_data.h>
 
 //This returns the PID of a process given by the scheduler at iter i or -1 if out of the schedulers range
 DEFN_SYSCALL1(get_process_id, 17, unsigned int);
@@ -8,6 +9,7 @@ DEFN_SYSCALL1(get_process_id, 17, unsigned int);
 DEFN_SYSCALL1(valid_process, 16, unsigned int);
 DEFN_SYSCALL1(get_processing_time, 18, unsigned int);
 DEFN_SYSCALL2(get_process_name, 19, char*, unsigned int);
+DEFN_SYSCALL2(get_cpu_time, 31, unsigned int, process_info_t*);
 
 int getProcessID(unsigned int n) {
 	int pid = syscall_get_process_id(n);
@@ -22,9 +24,14 @@ process_info_t getProcessInfo(int pid) {
 		info.pID = pid;
 		info.processingTime = syscall_get_processing_time(pid);
 		syscall_get_process_name(info.Name, pid);
+		syscall_get_cpu_time(pid, &info);
 	} else {
 		info.pID = -1;
 	}
 
 	return info;
 }
+
+int getCurrentProcessID() {
+	return ((const process_data_page_t*) PROCESS_DATA_PAGE_ADDRESS)->pid;
+}
@@ -0,0 +1,22 @@
+#include <process/ipc.h>
+
+DEFN_SYSCALL2(ipc_call, 35, unsigned int, ipc_message_t*);
+DEFN_SYSCALL1(ipc_receive, 36, ipc_message_t*);
+DEFN_SYSCALL2(ipc_reply, 37, unsigned int, ipc_message_t*);
+DEFN_SYSCALL2(ipc_reply_receive, 38, unsigned int, ipc_message_t*);
+
+int ipcCall(int pid, ipc_message_t* msg) {
+	return syscall_ipc_call(pid, msg);
+}
+
+int ipcReceive(ipc_message_t* msg) {
+	return syscall_ipc_receive(msg);
+}
+
+int ipcReply(int pid, ipc_message_t* msg) {
+	return syscall_ipc_reply(pid, msg);
+}
+
+int ipcReplyReceive(int pid, ipc_message_t* msg) {
+	return syscall_ipc_reply_receive(pid, msg);
+}
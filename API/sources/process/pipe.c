@@ -0,0 +1,22 @@
+#include <process/pipe.h>
+
+DEFN_SYSCALL2(pipe_create, 41, int*, unsigned int);
+DEFN_SYSCALL4(handle_read, 42, int, void*, unsigned int, unsigned int);
+DEFN_SYSCALL4(handle_write, 43, int, const void*, unsigned int, unsigned int);
+DEFN_SYSCALL1(handle_close, 44, int);
+
+int pipeCreate(int* handles, unsigned int flags) {
+	return syscall_pipe_create(handles, flags);
+}
+
+int handleRead(int handle, void* buffer, unsigned int length, unsigned int flags) {
+	return syscall_handle_read(handle, buffer, length, flags);
+}
+
+int handleWrite(int handle, const void* buffer, unsigned int length, unsigned int flags) {
+	return syscall_handle_write(handle, buffer, length, flags);
+}
+
+int handleClose(int handle) {
+	return syscall_handle_close(handle);
+}
@@ -0,0 +1,17 @@
+#include <process/poll.h>
+
+DEFN_SYSCALL4(poll_add, 46, unsigned int, unsigned int, unsigned int, unsigned int);
+DEFN_SYSCALL1(poll_remove, 47, int);
+DEFN_SYSCALL3(poll_wait, 48, poll_event_t*, unsigned int, unsigned long);
+
+int pollAdd(unsigned int source, unsigned int id, unsigned int events, unsigned int userData) {
+	return syscall_poll_add(source, id, events, userData);
+}
+
+int pollRemove(int registration) {
+	return syscall_poll_remove(registration);
+}
+
+int pollWait(poll_event_t* events, unsigned int max, unsigned long ticks) {
+	return syscall_poll_wait(events, max, ticks);
+}
@@ -1,5 +1,6 @@
 #include <process/postbox_api.h>
 #include <types/stdint.h>
+#include <common.h>
 
 //Read top reads a message from the top of the postbox
 DEFN_SYSCALL1(postbox_read_top, 1, process_message*);
@@ -13,17 +14,56 @@ DEFN_SYSCALL0(postbox_has_next, 3);
 //Sets the flags on this process's postbox
 DEFN_SYSCALL1(postbox_set_flags, 6, uint32_t);
 
+//Pops a number of messages from the postbox into a buffer
+DEFN_SYSCALL2(postbox_read_batch, 32, process_message*, unsigned int);
+
+//Blocks untill there is a message to read
+DEFN_SYSCALL1(postbox_wait, 33, unsigned long);
+
+//Sends a message to every process subscribed to an event
+DEFN_SYSCALL2(postbox_broadcast, 34, process_message*, uint32_t);
+
+//Sends a message (and pages of memory) to a process
+DEFN_SYSCALL4(postbox_send, 39, unsigned int, process_message*, void*, unsigned int);
+
+//Sets the limit and policy of this process's postbox
+DEFN_SYSCALL2(postbox_set_limit, 40, unsigned int, unsigned char);
+
 unsigned char postboxHasNext() {
 	return syscall_postbox_has_next();
 }
 
 process_message postboxGetNext() {
 	process_message msg;
-	syscall_postbox_read_top(&msg);
-	syscall_postbox_pop_top();
+
+	//Reading and popping in one go maps any pages granted with the message
+	if (!syscall_postbox_read_batch(&msg, 1)) {
+		memset(&msg, 0, sizeof(process_message));
+	}
+
 	return msg;
 }
 
+unsigned int postboxGetBatch(process_message* buffer, unsigned int max) {
+	return syscall_postbox_read_batch(buffer, max);
+}
+
+unsigned char postboxWait(unsigned long timeout) {
+	return syscall_postbox_wait(timeout);
+}
+
+int postboxBroadcast(process_message* msg, uint32_t bit) {
+	return syscall_postbox_broadcast(msg, bit);
+}
+
+int postboxSend(int pid, process_message* msg, void* address, unsigned int pages) {
+	return syscall_postbox_send(pid, msg, address, pages);
+}
+
+void postboxSetLimit(unsigned int limit, unsigned char policy) {
+	syscall_postbox_set_limit(limit, policy);
+}
+
 void postboxSetFlags(uint32_t flags) {
 	syscall_postbox_set_flags(flags);
 }
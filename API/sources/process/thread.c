@@ -0,0 +1,54 @@
+#include <process/thread.h>
+#include <process/wait.h>
+#include <process/end_process.h>
+
+DEFN_SYSCALL4(create_thread, 27, thread_entry_t, void*, MEM_LOC, thread_block_t*);
+DEFN_SYSCALL1(set_thread_tls, 28, thread_block_t*);
+
+//The main thread starts with a TLS segment based at 0, it is given this block before the first thread is created
+static thread_block_t mainThreadBlock;
+static unsigned char mainThreadBlockSet = 0;
+
+static thread_block_t* threadCurrentBlock() {
+
+	//Only the main thread can be running untill the first thread is created
+	if (!mainThreadBlockSet) {
+		mainThreadBlock.self = &mainThreadBlock;
+		mainThreadBlock.value = 0;
+		syscall_set_thread_tls(&mainThreadBlock);
+		mainThreadBlockSet = 1;
+	}
+
+	thread_block_t* block;
+	__asm__ volatile("mov %%fs:0, %0" : "=r" (block));
+	return block;
+}
+
+int threadCreate(thread_entry_t entry, void* argument, void* stack, unsigned long stackSize) {
+
+	threadCurrentBlock();
+
+	//The block goes at the top of the stack and the stack grows down from just below it
+	MEM_LOC top = ((MEM_LOC) stack + stackSize) & ~0xF;
+	thread_block_t* block = (thread_block_t*) (top - sizeof(thread_block_t));
+	block->self = block;
+	block->value = 0;
+
+	return syscall_create_thread(entry, argument, ((MEM_LOC) block) & ~0xF, block);
+}
+
+int threadJoin(int id) {
+	return waitProcess(id);
+}
+
+void threadExit(int value) {
+	exit(value);
+}
+
+void threadSetSpecific(void* value) {
+	threadCurrentBlock()->value = value;
+}
+
+void* threadGetSpecific() {
+	return threadCurrentBlock()->value;
+}
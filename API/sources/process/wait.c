@@ -0,0 +1,7 @@
+#include <process/wait.h>
+
+DEFN_SYSCALL1(wait_process, 23, unsigned int);
+
+int waitProcess(int pid) {
+	return syscall_wait_process(pid);
+}
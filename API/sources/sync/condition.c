@@ -0,0 +1,35 @@
+#include <sync/condition.h>
+
+void conditionInit(condition_t* condition) {
+	condition->sequence = 0;
+	condition->waiters = 0;
+}
+
+unsigned char conditionWait(condition_t* condition, mutex_t* mutex, unsigned long timeout) {
+	uint32_t sequence = condition->sequence;
+	syncFetchAdd(&condition->waiters, 1);
+
+	mutexUnlock(mutex);
+	int result = futexWait(&condition->sequence, sequence, timeout);
+
+	syncFetchAdd(&condition->waiters, -1);
+	mutexLock(mutex);
+
+	return result != FUTEX_TIMED_OUT;
+}
+
+static void conditionWake(condition_t* condition, uint32_t count) {
+	syncFetchAdd(&condition->sequence, 1);
+
+	if (condition->waiters) {
+		futexWake(&condition->sequence, count);
+	}
+}
+
+void conditionSignal(condition_t* condition) {
+	conditionWake(condition, 1);
+}
+
+void conditionBroadcast(condition_t* condition) {
+	conditionWake(condition, FUTEX_WAKE_ALL);
+}
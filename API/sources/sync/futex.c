@@ -0,0 +1,12 @@
+#include <sync/futex.h>
+
+DEFN_SYSCALL3(futex_wait, 29, volatile uint32_t*, uint32_t, unsigned long);
+DEFN_SYSCALL2(futex_wake, 30, volatile uint32_t*, uint32_t);
+
+int futexWait(volatile uint32_t* address, uint32_t expected, unsigned long timeout) {
+	return syscall_futex_wait(address, expected, timeout);
+}
+
+int futexWake(volatile uint32_t* address, uint32_t count) {
+	return syscall_futex_wake(address, count);
+}
@@ -0,0 +1,40 @@
+#include <sync/mutex.h>
+
+#define MUTEX_UNLOCKED 0
+#define MUTEX_LOCKED 1
+#define MUTEX_CONTENDED 2
+
+void mutexInit(mutex_t* mutex) {
+	mutex->state = MUTEX_UNLOCKED;
+}
+
+void mutexLock(mutex_t* mutex) {
+	uint32_t state = syncCompareExchange(&mutex->state, MUTEX_UNLOCKED, MUTEX_LOCKED);
+
+	if (state == MUTEX_UNLOCKED) {
+		return;
+	}
+
+	//Mark the mutex contended before sleeping so the holder knows to wake somebody. Whoever takes it from here on
+	//keeps it marked contended as there may be other sleepers left
+	if (state != MUTEX_CONTENDED) {
+		state = syncExchange(&mutex->state, MUTEX_CONTENDED);
+	}
+
+	while (state != MUTEX_UNLOCKED) {
+		futexWait(&mutex->state, MUTEX_CONTENDED, 0);
+		state = syncExchange(&mutex->state, MUTEX_CONTENDED);
+	}
+}
+
+unsigned char mutexTryLock(mutex_t* mutex) {
+	return syncCompareExchange(&mutex->state, MUTEX_UNLOCKED, MUTEX_LOCKED) == MUTEX_UNLOCKED;
+}
+
+void mutexUnlock(mutex_t* mutex) {
+
+	if (syncFetchAdd(&mutex->state, -1) != MUTEX_LOCKED) {
+		mutex->state = MUTEX_UNLOCKED;
+		futexWake(&mutex->state, 1);
+	}
+}
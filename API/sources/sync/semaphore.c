@@ -0,0 +1,37 @@
+#include <sync/semaphore.h>
+
+void semaphoreInit(semaphore_t* semaphore, uint32_t count) {
+	semaphore->count = count;
+	semaphore->waiters = 0;
+}
+
+unsigned char semaphoreWait(semaphore_t* semaphore, unsigned long timeout) {
+
+	for (;;) {
+		uint32_t count = semaphore->count;
+
+		if (count > 0) {
+			if (syncCompareExchange(&semaphore->count, count, count - 1) == count) {
+				return 1;
+			}
+
+			continue;
+		}
+
+		syncFetchAdd(&semaphore->waiters, 1);
+		int result = futexWait(&semaphore->count, 0, timeout);
+		syncFetchAdd(&semaphore->waiters, -1);
+
+		if (result == FUTEX_TIMED_OUT) {
+			return 0;
+		}
+	}
+}
+
+void semaphorePost(semaphore_t* semaphore) {
+	syncFetchAdd(&semaphore->count, 1);
+
+	if (semaphore->waiters) {
+		futexWake(&semaphore->count, 1);
+	}
+}
@@ -0,0 +1,49 @@
+#include <syscall/ring.h>
+#include <common.h>
+
+DEFN_SYSCALL2(ring_register, 25, syscall_ring_t*, uint32_t);
+DEFN_SYSCALL0(ring_enter, 26);
+
+void syscallRingSetup(syscall_ring_t* ring, uint32_t flags) {
+
+	if (ring) {
+		memset(ring, 0, sizeof(syscall_ring_t));
+	}
+
+	syscall_ring_register(ring, flags);
+}
+
+unsigned char syscallRingSubmit(syscall_ring_t* ring, uint32_t opcode, uint32_t userData, MEM_LOC p1, MEM_LOC p2, MEM_LOC p3, MEM_LOC p4) {
+
+	if (ring->submissionTail - ring->submissionHead >= SYSCALL_RING_ENTRIES) {
+		return 0;
+	}
+
+	syscall_ring_submission_t* op = &ring->submissions[ring->submissionTail & SYSCALL_RING_MASK];
+	op->opcode = opcode;
+	op->userData = userData;
+	op->params[0] = p1;
+	op->params[1] = p2;
+	op->params[2] = p3;
+	op->params[3] = p4;
+
+	//The operation has to be written before the kernel can see it
+	asm volatile("" ::: "memory");
+	ring->submissionTail++;
+	return 1;
+}
+
+unsigned int syscallRingEnter() {
+	return syscall_ring_enter();
+}
+
+unsigned char syscallRingComplete(syscall_ring_t* ring, syscall_ring_completion_t* dest) {
+
+	if (ring->completionHead == ring->completionTail) {
+		return 0;
+	}
+
+	*dest = ring->completions[ring->completionHead & SYSCALL_RING_MASK];
+	ring->completionHead++;
+	return 1;
+}
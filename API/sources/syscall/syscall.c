@@ -0,0 +1,24 @@
+#include <syscall/syscall.h>
+
+#define SYSCALL_FAST_ENTRY_AVAILABLE 24
+
+//-1 untill the kernel has been asked
+static int fastEntryAvailable = -1;
+
+unsigned char syscallFastAvailable() {
+
+	if (fastEntryAvailable == -1) {
+		fastEntryAvailable = syscallInterrupt(SYSCALL_FAST_ENTRY_AVAILABLE, 0, 0, 0, 0, 0) == 1;
+	}
+
+	return fastEntryAvailable;
+}
+
+MEM_LOC syscallMake(MEM_LOC num, MEM_LOC p1, MEM_LOC p2, MEM_LOC p3, MEM_LOC p4, MEM_LOC p5) {
+
+	if (syscallFastAvailable()) {
+		return syscallFastEntry(num, p1, p2, p3, p4, p5);
+	}
+
+	return syscallInterrupt(num, p1, p2, p3, p4, p5);
+}
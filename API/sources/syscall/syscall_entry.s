@@ -0,0 +1,49 @@
+[BITS 32]
+[GLOBAL syscallInterrupt]
+[GLOBAL syscallFastEntry]
+
+; MEM_LOC syscallInterrupt(num, p1, p2, p3, p4, p5)
+syscallInterrupt:
+   push ebx
+   push esi
+   push edi
+
+   mov eax, [esp+16] ; The syscall number
+   mov ebx, [esp+20] ; and its parameters
+   mov ecx, [esp+24]
+   mov edx, [esp+28]
+   mov esi, [esp+32]
+   mov edi, [esp+36]
+   int 127
+
+   pop edi
+   pop esi
+   pop ebx
+   ret
+
+; MEM_LOC syscallFastEntry(num, p1, p2, p3, p4, p5)
+; The kernel returns to the address on top of the stack that ebp points at
+syscallFastEntry:
+   push ebp
+   push ebx
+   push esi
+   push edi
+
+   mov eax, [esp+20]
+   mov ebx, [esp+24]
+   mov ecx, [esp+28]
+   mov edx, [esp+32]
+   mov esi, [esp+36]
+   mov edi, [esp+40]
+
+   push .return
+   mov ebp, esp
+   sysenter
+
+.return:
+   add esp, 4
+   pop edi
+   pop esi
+   pop ebx
+   pop ebp
+   ret
@@ -1,7 +1,12 @@
 #include <system/run.h>
 #include <syscall/syscall.h>
 DEFN_SYSCALL1(request_run_nproc, 21, const char*);
+DEFN_SYSCALL3(request_run_redirected, 45, const char*, int, int);
 
-void systemRunNewProcess(const char* filename) {
-	syscall_request_run_nproc(filename);
+int systemRunNewProcess(const char* filename) {
+	return syscall_request_run_nproc(filename);
+}
+
+int systemRunRedirected(const char* filename, int stdinHandle, int stdoutHandle) {
+	return syscall_request_run_redirected(filename, stdinHandle, stdoutHandle);
 }
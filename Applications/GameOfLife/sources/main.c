@@ -173,6 +173,7 @@ void updateLogic()
 }
 
 int cSleep = 0;
+unsigned long nextGeneration = 0;
 
 /**
  * @brief The entry point of a text-based remake of the game of life for Dawn
@@ -266,11 +267,23 @@ int main(int argc, void* argv)
 
 		cSleep++;
 
-		if (running)
+		if (running && clock() >= nextGeneration)
 		{
 			updateLogic();
 			redraw();
-			sleepUnprecise(125);
+			nextGeneration = clock() + 125;
+		}
+
+		//Sleep untill there is input, or the next generation is due while running
+		unsigned long now = clock();
+
+		if (!running)
+		{
+			postboxWait(0);
+		}
+		else if (now < nextGeneration)
+		{
+			postboxWait(nextGeneration - now);
 		}
 
 	}
@@ -27,14 +27,107 @@
 #include <process/end_process.h>
 #include <system/memory.h>
 #include <process/sleep.h>
+#include <process/wait.h>
+#include <process/pipe.h>
 
 #define BIT_0 1
 
+//Messages are read from the postbox this many at a time, each batch is a single trip into the kernel
+#define LINE_BATCH 16
+
+//The most programs a single line can chain together with |
+#define LINE_MAX_STAGES 8
+
+process_message messages[LINE_BATCH];
+
 char Pointer[1024];
 int c_ptr = 0;
 
 unsigned long cps = 0;
 
+/**
+ * Cut the spaces off either end of the string, returning where it now starts
+ */
+char* trim(char* str)
+{
+	while (*str == ' ')
+	{
+		str++;
+	}
+
+	int end = strlen(str);
+
+	while (end > 0 && str[end - 1] == ' ')
+	{
+		str[--end] = '\0';
+	}
+
+	return str;
+}
+
+/**
+ * Run each program in the line (separated by |) with its output going to the input of the next one, and wait for all
+ * of them to exit
+ */
+void runPipeline(char* line)
+{
+	char* stages[LINE_MAX_STAGES];
+	int pids[LINE_MAX_STAGES];
+	int numStages = 1;
+
+	stages[0] = line;
+
+	for (char* iter = line; *iter; iter++)
+	{
+		if (*iter == '|' && numStages < LINE_MAX_STAGES)
+		{
+			*iter = '\0';
+			stages[numStages++] = iter + 1;
+		}
+	}
+
+	int input = HANDLE_NONE;
+
+	for (int i = 0; i < numStages; i++)
+	{
+		int handles[2] = { HANDLE_NONE, HANDLE_NONE };
+
+		if (i + 1 < numStages && pipeCreate(handles, 0) != 0)
+		{
+			printf("Unable to create a pipe\n");
+		}
+
+		stages[i] = trim(stages[i]);
+		pids[i] = systemRunRedirected(stages[i], input, handles[1]);
+
+		if (pids[i] < 0)
+		{
+			printf("Unable to run %s\n", stages[i]);
+		}
+
+		//Only the programs keep the pipes open, so each one sees the end of its input once the one before exits
+		if (input != HANDLE_NONE)
+		{
+			handleClose(input);
+		}
+
+		if (handles[1] != HANDLE_NONE)
+		{
+			handleClose(handles[1]);
+		}
+
+		input = handles[0];
+	}
+
+	for (int i = 0; i < numStages; i++)
+	{
+		if (pids[i] >= 0)
+		{
+			waitProcess(pids[i]);
+		}
+	}
+}
+
 char exec_cmd()
 {
 	printf("\n");
@@ -45,6 +138,7 @@ char exec_cmd()
 		printf("Line - Executable compiled for Kernel version %i.%i.%i codename \"%s\"\n", KVERSION_MAJOR, KVERSION_MINOR, KVERSION_BUILD, KVERSION_CODENAME);
 		printf("Compiled as part of OS version %i.%i.%i codename \"%s\"\n", OS_VERSION_MAJOR, OS_VERSION_MINOR, OS_VERSION_REVISION, OS_VERSION_CODENAME);
 		printf("Any line typed will attempt to open a program of that name and feed it the arguments, e.g. program -arg arg\n");
+		printf("Programs separated by | are run together, each reading what the one before it prints, e.g. lproc | wc\n");
 	}
 	else if (strcmp("debug_on", Pointer) == 0)
 	{
@@ -56,10 +150,80 @@ char exec_cmd()
 	}
 	else
 	{
+		//The program gets the keyboard untill it exits, so stop listening for input
+		postboxSetFlags(0);
+
+		runPipeline(Pointer);
+
+		//Throw away anything that arrived before the flags where cleared
+		process_message discarded[LINE_BATCH];
+
+		while (postboxGetBatch(discarded, LINE_BATCH) != 0)
+		{
+		}
+
+		postboxSetFlags(INPUT_BIT);
+	}
+
+	return 0;
+}
+
+/**
+ * Handle a message from the postbox, returns 1 if Line should exit
+ */
+char handleMessage(process_message* message)
+{
+	if (message->ID == INPUT_MESSAGE)
+	{
+		//Its a input message alright
+		if (message->message_data[0] == DEVICE_KEYBOARD)
+		{
+			//its a keyboard message even!
+			char C = getAsciFromScancode(message->message_data[1], message->message_data[2]);
+
+			if (C == '\r')
+			{	
+				if (c_ptr != 0)
+				{
+					if (exec_cmd() == 1)
+						return 1;
 
-		systemRunNewProcess(Pointer);
+					c_ptr = 0;
+					Pointer[c_ptr] = '\0';
+					printf("Line.x:> ");
+				}
+			}
+			else if (C == '\b')
+			{
+				if (c_ptr != 0)
+				{
+					printf("\b \b");
+					c_ptr--;
+					Pointer[c_ptr] = '\0';
+				}
+			}
+			else
+			{
+				Pointer[c_ptr] = C;
+				Pointer[c_ptr + 1] = '\0';
+				c_ptr++;
+				printf("%c", C);
+			}
+		}
+		else if (message->message_data[0] == DEVICE_MOUSE)
+		{
+
+			cls();
 
-		exit(0);
+			//Message from a the mouse
+			printf("Message Data: %i %i ", message->message_data[2], message->message_data[3]);
+
+			if (message->message_data[1] & BIT_0 == 1)
+			{
+				printf("LBTN");
+			}
+			printf("\n");
+		}
 	}
 
 	return 0;
@@ -83,67 +247,17 @@ int main(int argc, void* argv)
 
 	for (;;)
 	{
+		unsigned int received = postboxGetBatch(messages, LINE_BATCH);
 
-		if (postboxHasNext() == 1)
+		for (unsigned int i = 0; i < received; i++)
 		{
-			process_message message;
-			message = postboxGetNext();
-			
-			if (message.ID == INPUT_MESSAGE)
+			if (handleMessage(&messages[i]) == 1)
 			{
-				//Its a input message alright
-				if (message.message_data[0] == DEVICE_KEYBOARD)
-				{
-					//its a keyboard message even!
-					char C = getAsciFromScancode(message.message_data[1], message.message_data[2]);
-
-					if (C == '\r')
-					{	
-						if (c_ptr != 0)
-						{
-							if (exec_cmd() == 1)
-								break;
-
-							c_ptr = 0;
-							Pointer[c_ptr] = '\0';
-							printf("Line.x:> ");
-						}
-					}
-					else if (C == '\b')
-					{
-						if (c_ptr != 0)
-						{
-							printf("\b \b");
-							c_ptr--;
-							Pointer[c_ptr] = '\0';
-						}
-					}
-					else
-					{
-						Pointer[c_ptr] = C;
-						Pointer[c_ptr + 1] = '\0';
-						c_ptr++;
-						printf("%c", C);
-					}
-				}
-				else if (message.message_data[0] == DEVICE_MOUSE)
-				{
-
-					cls();
-
-					//Message from a the mouse
-					printf("Message Data: %i %i ", message.message_data[2], message.message_data[3]);
-
-					if (message.message_data[1] & BIT_0 == 1)
-					{
-						printf("LBTN");
-					}
-					printf("\n");
-				}
+				return 1;
 			}
 		}
 
-		sleepProcess();
+		postboxWait(0);
 	}
 
 	return 1;
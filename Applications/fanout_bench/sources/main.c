@@ -0,0 +1,97 @@
+#include <printf.h>
+#include <process/end_process.h>
+#include <process/postbox_api.h>
+#include <process/events.h>
+#include <process/thread.h>
+#include <sync/futex.h>
+#include <common.h>
+
+#define BENCH_ITERATIONS 1000
+
+//Idle threads are added this many at a time between runs, each one is an entry the scheduler knows about
+#define IDLE_STEP 64
+#define IDLE_MAX 128
+#define IDLE_STACK_SIZE 4096
+
+//Messages are drained from the postbox this many at a time after each run
+#define DRAIN_BATCH 64
+
+static char idleStacks[IDLE_MAX][IDLE_STACK_SIZE];
+static int idleThreads[IDLE_MAX];
+static volatile uint32_t release = 0;
+
+process_message drained[DRAIN_BATCH];
+
+static inline unsigned long long readTimestampCounter() {
+	unsigned int low, high;
+	asm volatile("rdtsc" : "=a" (low), "=d" (high));
+	return ((unsigned long long) high << 32) | low;
+}
+
+/**
+ * Idle threads sleep untill the benchmark is over
+ */
+static int idleEntry(void* argument) {
+	while (!release) {
+		futexWait(&release, 0, 0);
+	}
+
+	return 0;
+}
+
+/**
+ * Broadcast BENCH_ITERATIONS messages to the event only this process is subscribed to and return the cycles taken
+ * per broadcast. The messages are thrown away afterwards
+ */
+static unsigned long cyclesPerBroadcast() {
+	process_message msg;
+	memset(&msg, 0, sizeof(process_message));
+
+	unsigned long long start = readTimestampCounter();
+
+	for (unsigned int i = 0; i < BENCH_ITERATIONS; i++) {
+		postboxBroadcast(&msg, BROADCAST_BIT);
+	}
+
+	unsigned long cycles = (unsigned long) ((readTimestampCounter() - start) / BENCH_ITERATIONS);
+
+	while (postboxGetBatch(drained, DRAIN_BATCH) != 0) {
+	}
+
+	return cycles;
+}
+
+extern "C" {
+
+	int _start(int argc, void* argv)
+	{
+		postboxSetFlags(BROADCAST_BIT);
+
+		printf("Broadcast fan-out over %i broadcasts to one subscriber\n", BENCH_ITERATIONS);
+
+		int idle = 0;
+
+		for (;;) {
+			printf("%i idle threads: %i cycles\n", idle, cyclesPerBroadcast());
+
+			if (idle == IDLE_MAX) {
+				break;
+			}
+
+			for (int i = 0; i < IDLE_STEP; i++, idle++) {
+				idleThreads[idle] = threadCreate(idleEntry, 0, idleStacks[idle], IDLE_STACK_SIZE);
+			}
+		}
+
+		release = 1;
+		futexWake(&release, FUTEX_WAKE_ALL);
+
+		for (int i = 0; i < idle; i++) {
+			threadJoin(idleThreads[i]);
+		}
+
+		postboxSetFlags(0);
+		exit(0);
+	}
+
+}
@@ -0,0 +1,67 @@
+#include <printf.h>
+#include <process/end_process.h>
+#include <process/ipc.h>
+#include <process/thread.h>
+
+#define BENCH_ITERATIONS 10000
+#define SERVER_STACK_SIZE 4096
+
+//Labels the client calls the server with
+#define LABEL_ECHO 1
+#define LABEL_QUIT 2
+
+static char serverStack[SERVER_STACK_SIZE];
+
+static inline unsigned long long readTimestampCounter() {
+	unsigned int low, high;
+	asm volatile("rdtsc" : "=a" (low), "=d" (high));
+	return ((unsigned long long) high << 32) | low;
+}
+
+/**
+ * Answers every call with the message it was sent untill told to quit
+ */
+static int serverEntry(void* argument) {
+	ipc_message_t msg;
+	int caller = ipcReceive(&msg);
+
+	while (msg.label != LABEL_QUIT) {
+		caller = ipcReplyReceive(caller, &msg);
+	}
+
+	ipcReply(caller, &msg);
+	return 0;
+}
+
+extern "C" {
+
+	int _start(int argc, void* argv)
+	{
+		int server = threadCreate(serverEntry, 0, serverStack, SERVER_STACK_SIZE);
+
+		ipc_message_t msg;
+		msg.label = LABEL_ECHO;
+
+		printf("IPC round trip latency over %i calls\n", BENCH_ITERATIONS);
+
+		unsigned long long start = readTimestampCounter();
+
+		for (unsigned int i = 0; i < BENCH_ITERATIONS; i++) {
+			msg.data[0] = i;
+
+			if (ipcCall(server, &msg) != 0 || msg.data[0] != (long) i) {
+				printf("Call %i failed\n", i);
+				exit(-1);
+			}
+		}
+
+		printf("call/reply: %i cycles\n", (unsigned long) ((readTimestampCounter() - start) / BENCH_ITERATIONS));
+
+		msg.label = LABEL_QUIT;
+		ipcCall(server, &msg);
+		threadJoin(server);
+
+		exit(0);
+	}
+
+}
@@ -6,24 +6,54 @@
 #include <process/process_info.h>
 #include <process/get_info.h>
 #include <process/postbox_api.h>
+#include <syscall/ring.h>
+
+//Processes are looked up this many at a time, each batch is a single trip into the kernel
+#define LPROC_BATCH 16
+
+syscall_ring_t ring;
+process_info_t infoBatch[LPROC_BATCH];
 
 int _start(int argc, void* argv)
 {
 
 	unsigned int iterator = 0;
+	unsigned char done = 0;
 
-	while (1)
-	{
-		int pid = getProcessID(iterator);
-
-		if (pid == -1) break;
-
-		process_info_t info = getProcessInfo(pid);
-		printf("Process %i Name %s Time %i\n", info.pID, info.Name, info.processingTime);
+	syscallRingSetup(&ring, 0);
 
-		iterator++;
+	while (!done)
+	{
+		for (unsigned int i = 0; i < LPROC_BATCH; i++)
+		{
+			syscallRingSubmit(&ring, SYSCALL_RING_PROCESS_INFO, i, iterator + i, (MEM_LOC) &infoBatch[i], 0, 0);
+		}
+
+		syscallRingEnter();
+
+		syscall_ring_completion_t completion;
+
+		while (syscallRingComplete(&ring, &completion))
+		{
+			//Completions come back in the order they were submitted, the first missing process ends the list
+			if (completion.result != 1)
+			{
+				done = 1;
+			}
+
+			if (!done)
+			{
+				process_info_t* info = &infoBatch[completion.userData];
+				printf("Process %i Name %s Time %i CPU %u.%u%% (user %uus kernel %uus)\n", info->pID, info->Name,
+						info->processingTime, info->cpuUsage / 10, info->cpuUsage % 10, info->userTime, info->kernelTime);
+				printf("  Postbox %u waiting (high %u) %u sent %u dropped\n", info->postboxQueued,
+						info->postboxHighWater, info->postboxEnqueued, info->postboxDropped);
+				iterator++;
+			}
+		}
 	}
 
+	syscallRingSetup(0, 0);
 	printf("Done listing %i processes\n", iterator);
 
 	exit(0);
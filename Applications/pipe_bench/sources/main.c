@@ -0,0 +1,69 @@
+#include <printf.h>
+#include <process/end_process.h>
+#include <process/pipe.h>
+#include <process/thread.h>
+#include <clock/clock.h>
+
+//Everything is pushed through the pipe in chunks of this many bytes, BENCH_CHUNKS times
+#define BENCH_CHUNK_SIZE 4096
+#define BENCH_CHUNKS 4096
+#define WRITER_STACK_SIZE 4096
+
+static char writerStack[WRITER_STACK_SIZE];
+static char writeBuffer[BENCH_CHUNK_SIZE];
+static char readBuffer[BENCH_CHUNK_SIZE];
+
+/**
+ * Fills the pipe as fast as the reader empties it, then closes it so the reader sees the end
+ */
+static int writerEntry(void* argument) {
+	int handle = (int) argument;
+
+	for (unsigned int i = 0; i < BENCH_CHUNKS; i++) {
+		handleWrite(handle, writeBuffer, BENCH_CHUNK_SIZE, 0);
+	}
+
+	handleClose(handle);
+	return 0;
+}
+
+extern "C" {
+
+	int _start(int argc, void* argv)
+	{
+		int handles[2];
+
+		if (pipeCreate(handles, 0) != 0) {
+			printf("Unable to create a pipe\n");
+			exit(-1);
+		}
+
+		printf("Pipe throughput over %i KB in %i byte writes\n", (BENCH_CHUNKS * BENCH_CHUNK_SIZE) / 1024,
+				BENCH_CHUNK_SIZE);
+
+		unsigned long start = clock();
+		int writer = threadCreate(writerEntry, (void*) handles[1], writerStack, WRITER_STACK_SIZE);
+
+		unsigned long total = 0;
+		int read;
+
+		while ((read = handleRead(handles[0], readBuffer, BENCH_CHUNK_SIZE, 0)) > 0) {
+			total += read;
+		}
+
+		unsigned long ticks = clock() - start;
+		threadJoin(writer);
+		handleClose(handles[0]);
+
+		if (!ticks) {
+			ticks = 1;
+		}
+
+		//KB per tick scaled up to a second, then into MB with one decimal place
+		unsigned long kbPerSecond = (total / 1024) * getClocksPerSecond() / ticks;
+		printf("%i bytes in %i ticks: %i.%i MB/s\n", total, ticks, kbPerSecond / 1024, (kbPerSecond % 1024) * 10 / 1024);
+
+		exit(0);
+	}
+
+}
@@ -0,0 +1,42 @@
+#include <printf.h>
+#include <process/end_process.h>
+#include <syscall/syscall.h>
+
+#define BENCH_ITERATIONS 10000
+
+//A syscall that does nothing but return a value, so only the cost of getting in and out of the kernel is measured
+#define NULL_SYSCALL 24
+
+static inline unsigned long long readTimestampCounter() {
+	unsigned int low, high;
+	asm volatile("rdtsc" : "=a" (low), "=d" (high));
+	return ((unsigned long long) high << 32) | low;
+}
+
+static unsigned long cyclesPerCall(MEM_LOC (*entry)(MEM_LOC, MEM_LOC, MEM_LOC, MEM_LOC, MEM_LOC, MEM_LOC)) {
+	unsigned long long start = readTimestampCounter();
+
+	for (unsigned int i = 0; i < BENCH_ITERATIONS; i++) {
+		entry(NULL_SYSCALL, 0, 0, 0, 0, 0);
+	}
+
+	return (unsigned long) ((readTimestampCounter() - start) / BENCH_ITERATIONS);
+}
+
+extern "C" {
+
+	int _start(int argc, void* argv)
+	{
+		printf("Null syscall latency over %i calls\n", BENCH_ITERATIONS);
+		printf("int $127: %i cycles\n", cyclesPerCall(syscallInterrupt));
+
+		if (syscallFastAvailable()) {
+			printf("sysenter: %i cycles\n", cyclesPerCall(syscallFastEntry));
+		} else {
+			printf("sysenter: not supported\n");
+		}
+
+		exit(0);
+	}
+
+}
@@ -0,0 +1,56 @@
+#include <printf.h>
+#include <process/end_process.h>
+#include <process/pipe.h>
+
+#define READ_SIZE 512
+
+//Counts the lines, words and bytes of the input it is given through a pipe, e.g. lproc | wc
+char buffer[READ_SIZE];
+
+extern "C" {
+
+	int _start(int argc, void* argv)
+	{
+		unsigned long lines = 0;
+		unsigned long words = 0;
+		unsigned long bytes = 0;
+		unsigned char inWord = 0;
+
+		int read;
+
+		while ((read = handleRead(HANDLE_STDIN, buffer, READ_SIZE, 0)) > 0)
+		{
+			for (int i = 0; i < read; i++)
+			{
+				char c = buffer[i];
+
+				if (c == '\n')
+				{
+					lines++;
+				}
+
+				if (c == ' ' || c == '\n' || c == '\t')
+				{
+					inWord = 0;
+				}
+				else if (!inWord)
+				{
+					inWord = 1;
+					words++;
+				}
+			}
+
+			bytes += read;
+		}
+
+		if (read == HANDLE_ERROR_BAD)
+		{
+			printf("wc counts what is piped into it, e.g. lproc | wc\n");
+			exit(-1);
+		}
+
+		printf("%i lines %i words %i bytes\n", lines, words, bytes);
+		exit(0);
+	}
+
+}
@@ -2,6 +2,7 @@
 #include <panic/panic.h>
 #include <scheduler/scheduler.h>
 #include <lists/linked.h>
+#include <system/kernel_data_page.h>
 
 //a unsigned long is used to store the number of ticks that have occured since boot
 unsigned long systemClockTicks;
@@ -16,12 +17,14 @@ linked_list_t* callbackList;
 void clockHandleTick() {
 	linked_list_t* iter = callbackList;
 
+	//Count the tick first, a callback (the scheduler) may switch away and not come back for a while
+	systemClockTicks++;
+	kernelDataPageTick();
+
 	while (iter) {
 		((clock_callback)iter->payload)();
 		iter = linkedListNext(iter);
 	}
-
-	systemClockTicks++;
 }
 
 void registerClockTickCallback(clock_callback cb) {
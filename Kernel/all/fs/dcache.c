@@ -0,0 +1,154 @@
+#include <fs/dcache.h>
+#include <lock/spinlock.h>
+#include <common.h>
+
+typedef struct {
+	fs_node_t* parent;
+	fs_node_t* node;
+	uint32_t hash;
+
+	/**
+	 * The number (plus one) of the next entry in the same bucket, 0 at the end
+	 */
+	unsigned int next;
+
+	unsigned char used;
+	char name[DCACHE_NAME_LENGTH];
+} dcache_entry_t;
+
+static dcache_entry_t entries[DCACHE_ENTRIES];
+
+/**
+ * The number (plus one) of the first entry in each bucket and the entry the next insert uses
+ */
+static unsigned int buckets[DCACHE_BUCKETS];
+static unsigned int nextEntry = 0;
+
+//Lookups are made by many readers of the tree at once, the cache needs its own lock
+static spinlock_t dcacheLock = SPINLOCK_INIT("dentry cache");
+
+static uint32_t dcacheHash(fs_node_t* parent, const char* name) {
+
+	//FNV-1a over the name followed by the parent
+	uint32_t hash = 2166136261u;
+
+	for (; *name; name++) {
+		hash = (hash ^ (uint8_t) *name) * 16777619u;
+	}
+
+	return (hash ^ (uint32_t) parent) * 16777619u;
+}
+
+/**
+ * Returns the link pointing at the entry for the name in the directory given, or at the end of its bucket if there is
+ * none. dcacheLock must be held
+ */
+static unsigned int* dcacheFindLocked(fs_node_t* parent, const char* name, uint32_t hash) {
+	unsigned int* iterator = &buckets[hash % DCACHE_BUCKETS];
+
+	while (*iterator) {
+		dcache_entry_t* entry = &entries[*iterator - 1];
+
+		if (entry->hash == hash && entry->parent == parent && strcmp(entry->name, name) == 0) {
+			break;
+		}
+
+		iterator = &entry->next;
+	}
+
+	return iterator;
+}
+
+/**
+ * Take the entry out of its bucket and mark it free. dcacheLock must be held
+ */
+static void dcacheRemoveLocked(unsigned int index) {
+	unsigned int* iterator = &buckets[entries[index].hash % DCACHE_BUCKETS];
+
+	while (*iterator != index + 1) {
+		iterator = &entries[*iterator - 1].next;
+	}
+
+	*iterator = entries[index].next;
+	entries[index].used = 0;
+}
+
+unsigned char dcacheLookup(fs_node_t* parent, const char* name, fs_node_t** result) {
+
+	if (strlen(name) >= DCACHE_NAME_LENGTH) {
+		return 0;
+	}
+
+	uint32_t hash = dcacheHash(parent, name);
+
+	spinlockAcquire(&dcacheLock);
+
+	unsigned int* link = dcacheFindLocked(parent, name, hash);
+	unsigned char found = *link != 0;
+
+	if (found) {
+		*result = entries[*link - 1].node;
+	}
+
+	spinlockRelease(&dcacheLock);
+	return found;
+}
+
+void dcacheInsert(fs_node_t* parent, const char* name, fs_node_t* node) {
+
+	if (strlen(name) >= DCACHE_NAME_LENGTH) {
+		return;
+	}
+
+	uint32_t hash = dcacheHash(parent, name);
+
+	spinlockAcquire(&dcacheLock);
+
+	//Another lookup of the same name may have got here first
+	unsigned int* link = dcacheFindLocked(parent, name, hash);
+
+	if (*link) {
+		entries[*link - 1].node = node;
+		spinlockRelease(&dcacheLock);
+		return;
+	}
+
+	unsigned int index = nextEntry;
+	nextEntry = (nextEntry + 1) % DCACHE_ENTRIES;
+
+	if (entries[index].used) {
+		dcacheRemoveLocked(index);
+	}
+
+	dcache_entry_t* entry = &entries[index];
+
+	entry->parent = parent;
+	entry->node = node;
+	entry->hash = hash;
+	entry->used = 1;
+	strcpy(entry->name, name);
+
+	entry->next = buckets[hash % DCACHE_BUCKETS];
+	buckets[hash % DCACHE_BUCKETS] = index + 1;
+
+	spinlockRelease(&dcacheLock);
+}
+
+void dcacheInvalidate(fs_node_t* parent, const char* name) {
+
+	if (strlen(name) >= DCACHE_NAME_LENGTH) {
+		return;
+	}
+
+	uint32_t hash = dcacheHash(parent, name);
+
+	spinlockAcquire(&dcacheLock);
+
+	unsigned int* link = dcacheFindLocked(parent, name, hash);
+
+	if (*link) {
+		dcacheRemoveLocked(*link - 1);
+	}
+
+	spinlockRelease(&dcacheLock);
+}
@@ -0,0 +1,36 @@
+#ifndef _DENTRY_CACHE_DEF_H_
+#define _DENTRY_CACHE_DEF_H_
+#include <fs/vfs.h>
+
+/**
+ * The dentry cache remembers what finddir returned for a name in a directory, including names that weren't found,
+ * so a path that has been looked up before is resolved with a hash probe per component instead of a scan of every
+ * directory along it. Entries are dropped when a node is bound to or unbound from the directory they are in
+ */
+#define DCACHE_BUCKETS 256
+#define DCACHE_ENTRIES 512
+
+/**
+ * Longer names are always looked up with finddir
+ */
+#define DCACHE_NAME_LENGTH 32
+
+/**
+ * Look up the name in the directory given. Returns 1 and sets result if the cache knows the answer, result is 0 if
+ * the name is known not to exist
+ */
+unsigned char dcacheLookup(fs_node_t* parent, const char* name, fs_node_t** result);
+
+/**
+ * Remember what looking up the name in the directory given returned, node is 0 if nothing was found. Anything already
+ * cached for the name is replaced. Entries are reused in turn, so once the cache has filled up each insert throws
+ * away the oldest
+ */
+void dcacheInsert(fs_node_t* parent, const char* name, fs_node_t* node);
+
+/**
+ * Forget whatever is cached for the name in the directory given, called as a node of that name is bound or unbound
+ */
+void dcacheInvalidate(fs_node_t* parent, const char* name);
+
+#endif //_DENTRY_CACHE_DEF_H_
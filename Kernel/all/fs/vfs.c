@@ -1,12 +1,18 @@
 #include <stdlib.h>
 #include <heap/heap.h>
 #include <fs/vfs.h>
+#include <fs/dcache.h>
 #include "rfs.h"
 #include <debug/debug.h>
 #include <common.h>
+#include <lock/rwlock.h>
+#include <lock/atomic.h>
 
 fs_node_t* root_fs = 0;
 
+//Protects the shape of the tree. Path lookups and directory listings read it, binding and unbinding nodes writes it
+static rwlock_t vfsTreeLock = RWLOCK_INIT("vfs tree");
+
 void initialiseRootFilesystem() {
 	root_fs = createRfsDirectory("root", 0);
 }
@@ -29,7 +35,13 @@ unsigned long read_fs(fs_node_t* node, unsigned long offset, unsigned long size,
 }
 
 unsigned long write_fs(fs_node_t* node, unsigned long offset, unsigned long size, uint8_t* buffer) {
-	return node->write ? node->write(node, offset, size, buffer) : 0;
+	unsigned long written = node->write ? node->write(node, offset, size, buffer) : 0;
+
+	if (written) {
+		atomicFetchAdd(&node->version, 1);
+	}
+
+	return written;
 }
 
 void open_fs(fs_node_t* node) {
@@ -69,14 +81,20 @@ struct dirent readdir_fs(fs_node_t* node, uint32_t idx) {
 	}
 
 	if (node->readdir) {
-		return node->readdir(node, idx);
+		rwlockReadAcquire(&vfsTreeLock);
+		ret = node->readdir(node, idx);
+		rwlockReadRelease(&vfsTreeLock);
+		return ret;
 	}
 
 	strcpy(ret.name, "");
 	return ret;
 }
 
-fs_node_t* finddir_fs(fs_node_t* node, const char* name) {
+/**
+ * finddir_fs without taking the tree lock, the caller must hold it
+ */
+static fs_node_t* finddirLocked(fs_node_t* node, const char* name) {
 
 	if (strcmp(name, "..") == 0) {
 		return node->parent;
@@ -84,11 +102,27 @@ fs_node_t* finddir_fs(fs_node_t* node, const char* name) {
 		return node;
 	}
 
-	if (node->finddir) {
-		return (fs_node_t*) node->finddir(node, name);
+	if (!node->finddir) {
+		return 0;
+	}
+
+	//Entries only go stale when the tree changes, which can't happen while the tree lock is held for reading
+	fs_node_t* result;
+
+	if (dcacheLookup(node, name, &result)) {
+		return result;
 	}
 
-	return 0;
+	result = (fs_node_t*) node->finddir(node, name);
+	dcacheInsert(node, name, result);
+	return result;
+}
+
+fs_node_t* finddir_fs(fs_node_t* node, const char* name) {
+	rwlockReadAcquire(&vfsTreeLock);
+	fs_node_t* result = finddirLocked(node, name);
+	rwlockReadRelease(&vfsTreeLock);
+	return result;
 }
 
 /**
@@ -96,7 +130,10 @@ fs_node_t* finddir_fs(fs_node_t* node, const char* name) {
  */
 void bindnode_fs(fs_node_t* node, fs_node_t* target) {
 	if (node->bindnode) {
+		rwlockWriteAcquire(&vfsTreeLock);
 		node->bindnode(node, target);
+		dcacheInvalidate(node, target->name);
+		rwlockWriteRelease(&vfsTreeLock);
 	}
 }
 
@@ -106,42 +143,61 @@ void bindnode_fs(fs_node_t* node, fs_node_t* target) {
 
 void unbindnode_fs(fs_node_t* node, fs_node_t* target) {
 	if (node->unbindnode) {
+		rwlockWriteAcquire(&vfsTreeLock);
 		node->unbindnode(node, target);
+		dcacheInvalidate(node, target->name);
+		rwlockWriteRelease(&vfsTreeLock);
 	}
 }
 
 /**
- * Recursive search for node with string
+ * Walk the path a component at a time from current_node (or the root if it starts with a /), the caller must hold
+ * the tree lock
  */
-fs_node_t* evaluatePath(const char* path, fs_node_t* current_node) {
+static fs_node_t* evaluatePathLocked(const char* path, fs_node_t* current_node) {
+
+	//No component can be longer than the name of a node
+	char component[sizeof(current_node->name)];
 
 	if (!path) {
 		return 0;
 	}
 
 	if (path[0] == '/') {
-		return evaluatePath(path + 1, get_vfs());
+		current_node = get_vfs();
 	}
 
-	char* buffer = strchr(path, '/');
+	while (current_node) {
 
-	if (buffer == 0) {
-		if (strcmp(path, "") == 0) {
-			return current_node;
-		} else {
-			return finddir_fs(current_node, path);
+		//Empty components (a trailing / or two in a row) stay where they are
+		while (*path == '/') {
+			path++;
+		}
+
+		if (!*path) {
+			break;
 		}
-	} else {
-		char splitLeftBuffer[buffer - path + 1];
-		memcpy((void*) splitLeftBuffer, (void*) path, buffer - path);
-		splitLeftBuffer[buffer - path] = '\0';
 
-		fs_node_t* temp = finddir_fs(current_node, splitLeftBuffer);
+		const char* end = strchr(path, '/');
+		unsigned int length = end ? (unsigned int) (end - path) : strlen(path);
 
-		if (temp != 0) {
-			return evaluatePath(buffer + 1, temp);
+		if (length >= sizeof(component)) {
+			return 0;
 		}
 
-		return 0;
+		memcpy(component, (void*) path, length);
+		component[length] = '\0';
+
+		current_node = finddirLocked(current_node, component);
+		path += length;
 	}
+
+	return current_node;
+}
+
+fs_node_t* evaluatePath(const char* path, fs_node_t* current_node) {
+	rwlockReadAcquire(&vfsTreeLock);
+	fs_node_t* result = evaluatePathLocked(path, current_node);
+	rwlockReadRelease(&vfsTreeLock);
+	return result;
 }
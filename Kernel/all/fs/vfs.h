@@ -31,6 +31,7 @@ struct filesystem_node {
 	uint32_t flags; //32 bit bitmask for flags
 	unsigned long length; //long integer, size of the file.
 	unsigned long inode;
+	uint32_t version; //Bumped every time the file is written to so anything cached from it can tell it changed
 	disk_device* device; //Pointer to the disk device this file is located on
 
 	io_operation write;
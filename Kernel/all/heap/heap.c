@@ -18,8 +18,7 @@ size_t mapInitialHeap(MEM_LOC start) {
 	for (iter = start; iter <= start + PAGE_SIZE * HEAP_BASE_PAGES; iter +=
 			PAGE_SIZE) {
 
-		map(iter, allocateFrameForProcess(getCurrentProcess()),
-				MEMORY_RESTRICTED_ACCESS);
+		map(iter, allocateFrame(), MEMORY_RESTRICTED_ACCESS);
 	}
 
 	return HEAP_BASE_PAGES * PAGE_SIZE;
@@ -67,8 +66,9 @@ void expandHeap(heap_entry_t* last_heap_entry, MEM_LOC heap_end,
 
 	for (MEM_LOC iter = heap_end; iter <= heap_end + (PAGE_SIZE * expansionSize); iter +=
 			PAGE_SIZE) {
-		map(iter, allocateFrameForProcess(getCurrentProcess()),
-				MEMORY_RESTRICTED_ACCESS);
+		//Heap frames belong to the kernel, not whichever process happened to cause the expansion. Charging them to the
+		//process would also grow its used list, which allocates from the heap being expanded
+		map(iter, allocateFrame(), MEMORY_RESTRICTED_ACCESS);
 	}
 
 	if (last_heap_entry->used == 0) {
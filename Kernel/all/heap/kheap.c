@@ -1,15 +1,24 @@
 #include <heap/heap.h>
 #include <mm/virt_mm.h>
+#include <lock/spinlock.h>
 #define KERNEL_HEAP_ADDR KERNEL_START + 0x10000000
 
 heap_t kernel_heap;
 
+//Interrupt handlers allocate too (messages pushed to postboxes on input) so the lock is taken with interrupts off
+static spinlock_t kernelHeapLock = SPINLOCK_INIT("kernel heap");
+
 void* kmalloc(unsigned long mem) {
-	return heapAllocateMemory(mem, &kernel_heap);
+	irq_flags_t flags = spinlockAcquireIrqSave(&kernelHeapLock);
+	void* result = heapAllocateMemory(mem, &kernel_heap);
+	spinlockReleaseIrqRestore(&kernelHeapLock, flags);
+	return result;
 }
 
 void kfree(void* addr) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&kernelHeapLock);
 	heapFreeMemory(addr, &kernel_heap);
+	spinlockReleaseIrqRestore(&kernelHeapLock, flags);
 }
 
 void initializeKernelHeap() {
@@ -1,6 +1,7 @@
 #ifndef _LOADER_DEF_H_
 #define _LOADER_DEF_H_
 #include <loaders/elf_header.h>
+#include <types/memory.h>
 #include <fs/vfs.h>
 #include <stdlib.h>
 
@@ -10,6 +11,64 @@
 #define LOAD_ERROR_BAD_LOAD -8
 #define LOAD_ERROR_BAD_MAP -9
 
+/**
+ * The number of parsed images kept around for the next launch of the same file
+ */
+#define EXECUTABLE_CACHE_SIZE 8
+
+/**
+ * A validated executable, everything needed to load it into an address space without parsing the file again. Images
+ * are shared between the cache and every launch using them
+ */
+typedef struct {
+
+	/**
+	 * The file the image was parsed from and what it looked like at the time, the image is stale once either changes
+	 */
+	fs_node_t* node;
+	uint32_t version;
+	unsigned long length;
+
+	/**
+	 * The cache and each launch holds a reference
+	 */
+	uint32_t references;
+
+	/**
+	 * The address execution starts at
+	 */
+	MEM_LOC entry;
+
+	/**
+	 * The loadable segments of the file
+	 */
+	unsigned int numSegments;
+	e32_pheader* segments;
+
+} executable_image_t;
+
+/**
+ * Validate the ELF headers of the file given and read its loadable segments, or find the image from the last time the
+ * (unchanged) file was launched. Returns 0 and sets image on success or one of the LOAD_ERROR codes
+ */
+int executableImageParse(fs_node_t* node, executable_image_t** image);
+
+/**
+ * Map and read the segments of the image into the current address space. Returns 0 or one of the LOAD_ERROR codes
+ */
+int executableImageLoad(executable_image_t* image);
+
+/**
+ * Drop a reference to an image returned by executableImageParse
+ */
+void executableImageRelease(executable_image_t* image);
+
+/**
+ * Release the image and call its entry point (which has to be loaded) on the current stack, the process is killed
+ * once it returns
+ */
+void executableImageExecute(executable_image_t* image, unsigned char usermode);
+
 int loadAndExecuteProgram(fs_node_t* Node, unsigned char);
 
 #endif //_LOADER_DEF_H_
@@ -6,6 +6,12 @@
 MEM_LOC allocateFrame();
 MEM_LOC allocateFrameForProcess(process_t* proc);
 void freeFrame(MEM_LOC);
+
+/**
+ * freeFrame for a frame that isn't on the used list of any process (pages in flight between two of them). It only
+ * touches the free frame stack, so it is safe to call from interrupt handlers
+ */
+void freeUnownedFrame(MEM_LOC frame);
 unsigned long calculateFreeFrames();
 
 #endif //_PHYSICAL_MEMORY_ABSTRACT_HEADER_
@@ -0,0 +1,99 @@
+#include <process/accounting.h>
+#include <system/kernel_data_page.h>
+#include <clock/clock.h>
+#include <cpu/cpu.h>
+#include <cpu/percpu.h>
+#include <lock/atomic.h>
+#include <lock/spinlock.h>
+
+static unsigned char tscSupported = 0;
+
+void initializeAccounting() {
+	tscSupported = cpuidHasFeature(CPUID_FEATURE_TSC);
+}
+
+void accountingStart(process_t* process) {
+	process->startTsc = tscSupported ? readTimestampCounter() : 0;
+}
+
+void accountingCharge(process_t* process) {
+
+	if (!tscSupported) {
+		return;
+	}
+
+	//A switch on this CPU in the middle would charge the same cycles twice
+	irq_flags_t flags = interruptsSave();
+
+	cpu_t* cpu = getCpu();
+	uint64_t now = readTimestampCounter();
+
+	//Nothing is charged for the time before the first accounting point on a CPU
+	if (cpu->accountingTsc) {
+		if (process->syscallDepth) {
+			process->kernelCycles += now - cpu->accountingTsc;
+		} else {
+			process->userCycles += now - cpu->accountingTsc;
+		}
+	}
+
+	cpu->accountingTsc = now;
+
+	interruptsRestore(flags);
+}
+
+/**
+ * Convert TSC cycles to microseconds (0 untill the TSC is calibrated, 0xFFFFFFFF if it doesn't fit)
+ */
+static unsigned long cyclesToMicroseconds(uint64_t cycles) {
+	kernel_data_page_t* data = kernelDataPage();
+
+	if (!data || !data->tscPerTick) {
+		return 0;
+	}
+
+	uint32_t perMicrosecond = cyclesDivide(data->tscPerTick * CLOCKS_PER_SECOND, 1000000);
+
+	if (!perMicrosecond) {
+		return 0;
+	}
+
+	//The quotient has to fit in 32 bits or the divide faults
+	if ((uint32_t) (cycles >> 32) >= perMicrosecond) {
+		return 0xFFFFFFFF;
+	}
+
+	return cyclesDivide(cycles, perMicrosecond);
+}
+
+void accountingFillInfo(process_t* process, process_info_t* info) {
+	uint64_t user = process->userCycles;
+	uint64_t kernel = process->kernelCycles;
+
+	info->userTime = cyclesToMicroseconds(user);
+	info->kernelTime = cyclesToMicroseconds(kernel);
+	info->cpuUsage = 0;
+
+	if (!tscSupported) {
+		return;
+	}
+
+	//Share of the time since the process started, both are scaled down untill the lifetime fits the divisor
+	uint64_t used = user + kernel;
+	uint64_t lifetime = readTimestampCounter() - process->startTsc;
+
+	while (lifetime >> 32) {
+		lifetime >>= 1;
+		used >>= 1;
+	}
+
+	if (!lifetime) {
+		return;
+	}
+
+	if (used > lifetime) {
+		used = lifetime;
+	}
+
+	info->cpuUsage = cyclesDivide(used * 1000, (uint32_t) lifetime);
+}
@@ -0,0 +1,29 @@
+#ifndef _PROCESS_ACCOUNTING_DEF_H_
+#define _PROCESS_ACCOUNTING_DEF_H_
+#include <process/process.h>
+#include <process/process_info.h>
+
+/**
+ * Processes are charged for the timestamp counter cycles between each accounting point on the CPU running them (every
+ * switch away from them and every syscall entry and exit), as kernel time while inside a syscall and user time
+ * otherwise. Cycles are turned into time using the TSC rate calibrated against the clock by the kernel data page
+ */
+void initializeAccounting();
+
+/**
+ * Mark the process as starting now, called when it is handed to the scheduler
+ */
+void accountingStart(process_t* process);
+
+/**
+ * Charge the cycles since the last accounting point on this CPU to the process given, which has to be the one
+ * running on it
+ */
+void accountingCharge(process_t* process);
+
+/**
+ * Fill in the CPU time fields of the info given for the process
+ */
+void accountingFillInfo(process_t* process, process_info_t* info);
+
+#endif //_PROCESS_ACCOUNTING_DEF_H_
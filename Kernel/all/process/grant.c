@@ -0,0 +1,124 @@
+#include <process/grant.h>
+#include <process/process.h>
+#include <process/used_list.h>
+#include <scheduler/scheduler.h>
+#include <system/kernel_data.h>
+#include <mm/virtual.h>
+#include <mm/virt_mm.h>
+#include <mm/phys_mm.h>
+#include <lock/spinlock.h>
+#include <stdlib.h>
+
+//The first 4MB of every address space is the identity mapped kernel, it can't be granted
+#define GRANT_LOWEST_ADDRESS 0x400000
+
+int grantAttach(process_message* msg, MEM_LOC address, unsigned int pages) {
+	msg->grantPages = 0;
+	msg->grantFrames = 0;
+
+	if (!pages) {
+		return 0;
+	}
+
+	//Only the memory of the process itself, not the data page the kernel keeps for it or anything above
+	if ((address & ~PAGE_MASK) || address < GRANT_LOWEST_ADDRESS || address >= PROCESS_DATA_PAGE_ADDRESS
+			|| pages > (PROCESS_DATA_PAGE_ADDRESS - address) / PAGE_SIZE) {
+		return POSTBOX_ERROR_BAD_GRANT;
+	}
+
+	for (unsigned int i = 0; i < pages; i++) {
+		if (!getMapping(address + i * PAGE_SIZE, 0)) {
+			return POSTBOX_ERROR_BAD_GRANT;
+		}
+	}
+
+	process_t* leader = processLeader(getCurrentProcess());
+
+	//Unmapping only flushes the TLB of this CPU, a thread running on another one would keep writing to the frames
+	//after they belong to the receiver. With no other thread left nothing else can create one meanwhile, and every
+	//other CPU flushed the address space out of its TLB when it last switched away from it
+	if (leader->handleUsers > 1) {
+		return POSTBOX_ERROR_THREADED_GRANT;
+	}
+
+	MEM_LOC* frames = malloc(pages * sizeof(MEM_LOC));
+
+	for (unsigned int i = 0; i < pages; i++) {
+		MEM_LOC page = address + i * PAGE_SIZE;
+
+		getMapping(page, &frames[i]);
+		unmap(page);
+		usedListRemove(leader, (void*) frames[i]);
+	}
+
+	msg->grantPages = pages;
+	msg->grantFrames = (MEM_LOC) frames;
+	return 0;
+}
+
+/**
+ * Returns the lowest address in the grant region with the number of pages given free after it, or 0 if there is none
+ */
+static MEM_LOC grantFindSpace(unsigned int pages) {
+	unsigned int run = 0;
+
+	for (MEM_LOC page = GRANT_REGION_START; page < GRANT_REGION_END; page += PAGE_SIZE) {
+		run = getMapping(page, 0) ? 0 : run + 1;
+
+		if (run == pages) {
+			return page - (pages - 1) * PAGE_SIZE;
+		}
+	}
+
+	return 0;
+}
+
+void grantDeliver(process_message* msg) {
+
+	if (!msg->grantFrames) {
+		return;
+	}
+
+	MEM_LOC* frames = (MEM_LOC*) msg->grantFrames;
+	process_t* leader = processLeader(getCurrentProcess());
+
+	spinlockAcquire(&leader->grantLock);
+	MEM_LOC address = grantFindSpace(msg->grantPages);
+
+	if (!address) {
+		spinlockRelease(&leader->grantLock);
+		grantDiscard(msg);
+		msg->messageAdditionalData = 0;
+		return;
+	}
+
+	for (unsigned int i = 0; i < msg->grantPages; i++) {
+		map(address + i * PAGE_SIZE, frames[i], 0);
+		usedListAdd(leader, (void*) frames[i]);
+	}
+
+	spinlockRelease(&leader->grantLock);
+	free(frames);
+
+	msg->grantFrames = 0;
+	msg->messageAdditionalData = address;
+}
+
+void grantDiscard(process_message* msg) {
+
+	if (!msg->grantFrames) {
+		return;
+	}
+
+	MEM_LOC* frames = (MEM_LOC*) msg->grantFrames;
+
+	//The frames left the used list of the sender when they were attached
+	for (unsigned int i = 0; i < msg->grantPages; i++) {
+		freeUnownedFrame(frames[i]);
+	}
+
+	free(frames);
+
+	msg->grantPages = 0;
+	msg->grantFrames = 0;
+}
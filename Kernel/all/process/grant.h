@@ -0,0 +1,29 @@
+#ifndef _PROCESS_GRANT_DEF_H_
+#define _PROCESS_GRANT_DEF_H_
+#include <process/message.h>
+#include <types/memory.h>
+
+/**
+ * A message can carry pages from the address space of its sender to whoever reads it. The frames are taken out of the
+ * sender when the message is sent and mapped into the reader when it is read, so nothing is copied and the sender can
+ * no longer touch them.
+ *
+ * Unmap the pages [address, address + pages * PAGE_SIZE) from the current address space and attach them to msg.
+ * Returns 0, POSTBOX_ERROR_BAD_GRANT (leaving the address space alone) if the range isn't page aligned memory of
+ * the process or POSTBOX_ERROR_THREADED_GRANT if the process has other threads that haven't exited
+ */
+int grantAttach(process_message* msg, MEM_LOC address, unsigned int pages);
+
+/**
+ * Map the pages granted with msg (if it has any) into the current address space, pointing messageAdditionalData at
+ * them. The grant is dropped if there is no room for it
+ */
+void grantDeliver(process_message* msg);
+
+/**
+ * Free the pages granted with msg (if it has any), for messages thrown away without being read. Safe to call from
+ * interrupt handlers
+ */
+void grantDiscard(process_message* msg);
+
+#endif //_PROCESS_GRANT_DEF_H_
@@ -0,0 +1,217 @@
+#include <process/handles.h>
+#include <process/pipe.h>
+#include <process/poll.h>
+#include <process/process.h>
+#include <scheduler/scheduler.h>
+#include <lock/spinlock.h>
+
+/**
+ * Every handle table lives in the leader of its process and is protected by its handleLock
+ */
+static process_t* handlesOwner() {
+	return processLeader(getCurrentProcess());
+}
+
+int handlesCreatePipe(int* handles, uint32_t flags) {
+	process_t* process = handlesOwner();
+
+	spinlockAcquire(&process->handleLock);
+
+	//The two lowest free handles, input and output are only ever set up by whoever runs the process
+	int readHandle = -1;
+	int writeHandle = -1;
+
+	for (int i = HANDLE_STDOUT + 1; i < PROCESS_MAX_HANDLES && writeHandle == -1; i++) {
+		if (!process->handles[i].pipe) {
+			if (readHandle == -1) {
+				readHandle = i;
+			} else {
+				writeHandle = i;
+			}
+		}
+	}
+
+	if (writeHandle == -1) {
+		spinlockRelease(&process->handleLock);
+		return HANDLE_ERROR_TABLE_FULL;
+	}
+
+	pipe_t* pipe = pipeCreate();
+
+	if (!pipe) {
+		spinlockRelease(&process->handleLock);
+		return HANDLE_ERROR_NO_MEMORY;
+	}
+
+	process->handles[readHandle].pipe = pipe;
+	process->handles[readHandle].writeEnd = 0;
+	process->handles[readHandle].inherit = flags & HANDLE_INHERIT;
+
+	process->handles[writeHandle].pipe = pipe;
+	process->handles[writeHandle].writeEnd = 1;
+	process->handles[writeHandle].inherit = flags & HANDLE_INHERIT;
+
+	spinlockRelease(&process->handleLock);
+
+	handles[0] = readHandle;
+	handles[1] = writeHandle;
+	return 0;
+}
+
+/**
+ * Returns the pipe behind the handle if it is open on the end given with another handle opened on it for the caller
+ * to use, so the pipe stays around if the handle is closed meanwhile. 0 if the handle isn't open on that end
+ */
+static pipe_t* handlesUse(int handle, unsigned char writeEnd) {
+	process_t* process = handlesOwner();
+
+	if (handle < 0 || handle >= PROCESS_MAX_HANDLES) {
+		return 0;
+	}
+
+	spinlockAcquire(&process->handleLock);
+
+	pipe_t* pipe = process->handles[handle].pipe;
+
+	if (pipe && process->handles[handle].writeEnd == writeEnd) {
+		pipeOpenEnd(pipe, writeEnd);
+	} else {
+		pipe = 0;
+	}
+
+	spinlockRelease(&process->handleLock);
+	return pipe;
+}
+
+int handlesRead(int handle, uint8_t* dest, unsigned int length, uint32_t flags) {
+	pipe_t* pipe = handlesUse(handle, 0);
+
+	if (!pipe) {
+		return HANDLE_ERROR_BAD;
+	}
+
+	int result = pipeRead(pipe, dest, length, flags & HANDLE_NONBLOCK);
+	pipeCloseEnd(pipe, 0);
+	return result;
+}
+
+int handlesWrite(int handle, const uint8_t* src, unsigned int length, uint32_t flags) {
+	pipe_t* pipe = handlesUse(handle, 1);
+
+	if (!pipe) {
+		return HANDLE_ERROR_BAD;
+	}
+
+	int result = pipeWrite(pipe, src, length, flags & HANDLE_NONBLOCK);
+	pipeCloseEnd(pipe, 1);
+	return result;
+}
+
+int handlesClose(int handle) {
+	process_t* process = handlesOwner();
+
+	if (handle < 0 || handle >= PROCESS_MAX_HANDLES) {
+		return HANDLE_ERROR_BAD;
+	}
+
+	spinlockAcquire(&process->handleLock);
+
+	handle_t closing = process->handles[handle];
+	process->handles[handle].pipe = 0;
+
+	//Registrations on the handle go with it, the pipe may not outlive them
+	if (closing.pipe) {
+		pollHandleClosed(process, handle);
+	}
+
+	spinlockRelease(&process->handleLock);
+
+	if (!closing.pipe) {
+		return HANDLE_ERROR_BAD;
+	}
+
+	pipeCloseEnd(closing.pipe, closing.writeEnd);
+	return 0;
+}
+
+unsigned char handlesOpen(int handle) {
+	process_t* process = handlesOwner();
+	return handle >= 0 && handle < PROCESS_MAX_HANDLES && process->handles[handle].pipe != 0;
+}
+
+/**
+ * Copy the handle of the parent into the child, opening another handle on its pipe. The parents handleLock must be held
+ */
+static void handlesCopy(process_t* child, int childHandle, process_t* parent, int parentHandle) {
+	handle_t* from = &parent->handles[parentHandle];
+
+	if (!from->pipe) {
+		return;
+	}
+
+	pipeOpenEnd(from->pipe, from->writeEnd);
+
+	//The child isn't running yet, nothing else can be touching its table
+	if (child->handles[childHandle].pipe) {
+		pipeCloseEnd(child->handles[childHandle].pipe, child->handles[childHandle].writeEnd);
+	}
+
+	child->handles[childHandle] = *from;
+}
+
+void handlesInherit(process_t* child, int stdinHandle, int stdoutHandle) {
+	process_t* parent = handlesOwner();
+
+	child->handleUsers = 1;
+
+	spinlockAcquire(&parent->handleLock);
+
+	for (int i = 0; i < PROCESS_MAX_HANDLES; i++) {
+		if (parent->handles[i].inherit) {
+			handlesCopy(child, i, parent, i);
+		}
+	}
+
+	if (stdinHandle >= 0 && stdinHandle < PROCESS_MAX_HANDLES) {
+		handlesCopy(child, HANDLE_STDIN, parent, stdinHandle);
+	}
+
+	if (stdoutHandle >= 0 && stdoutHandle < PROCESS_MAX_HANDLES) {
+		handlesCopy(child, HANDLE_STDOUT, parent, stdoutHandle);
+	}
+
+	spinlockRelease(&parent->handleLock);
+}
+
+void handlesAddUser(process_t* leader) {
+	spinlockAcquire(&leader->handleLock);
+	leader->handleUsers++;
+	spinlockRelease(&leader->handleLock);
+}
+
+void handlesProcessExit(process_t* process) {
+	process_t* leader = processLeader(process);
+	handle_t closing[PROCESS_MAX_HANDLES];
+	unsigned char last = 0;
+
+	spinlockAcquire(&leader->handleLock);
+
+	if (leader->handleUsers && !--leader->handleUsers) {
+		pollFree(leader);
+		memcpy(closing, leader->handles, sizeof(closing));
+		memset(leader->handles, 0, sizeof(closing));
+		last = 1;
+	}
+
+	spinlockRelease(&leader->handleLock);
+
+	if (!last) {
+		return;
+	}
+
+	for (int i = 0; i < PROCESS_MAX_HANDLES; i++) {
+		if (closing[i].pipe) {
+			pipeCloseEnd(closing[i].pipe, closing[i].writeEnd);
+		}
+	}
+}
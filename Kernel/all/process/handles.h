@@ -0,0 +1,58 @@
+#ifndef _PROCESS_HANDLES_DEF_H_
+#define _PROCESS_HANDLES_DEF_H_
+#include <syscall/syscall_handles.h>
+#include <types/stdint.h>
+
+struct processStructure;
+struct pipe;
+
+/**
+ * An entry in the handle table of a process, a free entry has no pipe
+ */
+typedef struct {
+	struct pipe* pipe;
+	unsigned char writeEnd;
+	unsigned char inherit;
+} handle_t;
+
+/**
+ * Install the two ends of a new pipe in the handle table of the current process, setting handles[0] to the read end
+ * and handles[1] to the write end. Returns 0, HANDLE_ERROR_TABLE_FULL or HANDLE_ERROR_NO_MEMORY
+ */
+int handlesCreatePipe(int* handles, uint32_t flags);
+
+/**
+ * Read from / write to the pipe end behind a handle of the current process, see pipeRead and pipeWrite. Returns
+ * HANDLE_ERROR_BAD if the handle isn't open on the right end
+ */
+int handlesRead(int handle, uint8_t* dest, unsigned int length, uint32_t flags);
+int handlesWrite(int handle, const uint8_t* src, unsigned int length, uint32_t flags);
+
+/**
+ * Close a handle of the current process, returns 0 or HANDLE_ERROR_BAD
+ */
+int handlesClose(int handle);
+
+/**
+ * Returns 1 if the handle of the current process given is open
+ */
+unsigned char handlesOpen(int handle);
+
+/**
+ * Fill in the handle table of a process that is about to be run from the current process: every inheritable handle
+ * goes in the same place, then the handles given (unless they are HANDLE_NONE) become its input and output
+ */
+void handlesInherit(struct processStructure* child, int stdinHandle, int stdoutHandle);
+
+/**
+ * Count another thread using the handle table of the leader given
+ */
+void handlesAddUser(struct processStructure* leader);
+
+/**
+ * Called as a process or thread exits, the handles of the process are closed once it and all its threads have
+ * exited so whoever is at the other end of its pipes finds out straight away
+ */
+void handlesProcessExit(struct processStructure* process);
+
+#endif //_PROCESS_HANDLES_DEF_H_
@@ -0,0 +1,268 @@
+#include <process/pipe.h>
+#include <process/poll.h>
+#include <process/process_queue.h>
+#include <scheduler/scheduler.h>
+#include <lock/spinlock.h>
+#include <stdlib.h>
+#include <common.h>
+
+//Data is copied between the pipe and the callers buffer through this much of the kernel stack at a time, touching
+//the callers buffer can fault and the lock must not be held if it does
+#define PIPE_COPY_CHUNK 256
+
+struct pipe {
+
+	/**
+	 * PIPE_BUFFER_SIZE bytes, used holds how many of them starting at head are waiting to be read. The buffer comes from
+	 * the kernel heap like kernel stacks do, the kernel has no way to map pages of its own outside of the heap
+	 */
+	uint8_t* buffer;
+	unsigned int head;
+	unsigned int used;
+
+	/**
+	 * The handles open on each end
+	 */
+	unsigned int readers;
+	unsigned int writers;
+
+	//Protects everything in the pipe, it is never taken from interrupt handlers
+	spinlock_t lock;
+
+	/**
+	 * Processes sleeping untill there is something to read / room to write
+	 */
+	process_queue_t readWaiters;
+	process_queue_t writeWaiters;
+
+	/**
+	 * Poll registrations on the read end and on the write end
+	 */
+	poll_watch_t* readWatchers;
+	poll_watch_t* writeWatchers;
+};
+
+pipe_t* pipeCreate() {
+	pipe_t* pipe = malloc(sizeof(pipe_t));
+
+	if (!pipe) {
+		return 0;
+	}
+
+	memset(pipe, 0, sizeof(pipe_t));
+	pipe->buffer = malloc(PIPE_BUFFER_SIZE);
+
+	if (!pipe->buffer) {
+		free(pipe);
+		return 0;
+	}
+
+	pipe->readers = 1;
+	pipe->writers = 1;
+	spinlockInit(&pipe->lock, "pipe");
+
+	return pipe;
+}
+
+void pipeOpenEnd(pipe_t* pipe, unsigned char writeEnd) {
+	spinlockAcquire(&pipe->lock);
+
+	if (writeEnd) {
+		pipe->writers++;
+	} else {
+		pipe->readers++;
+	}
+
+	spinlockRelease(&pipe->lock);
+}
+
+void pipeCloseEnd(pipe_t* pipe, unsigned char writeEnd) {
+	spinlockAcquire(&pipe->lock);
+
+	//Whoever is waiting on the other end has to find out it is gone
+	if (writeEnd) {
+		pipe->writers--;
+
+		if (!pipe->writers) {
+			schedulerWakeAll(&pipe->readWaiters);
+			pollNotify(pipe->readWatchers, POLL_READABLE | POLL_HANGUP);
+		}
+	} else {
+		pipe->readers--;
+
+		if (!pipe->readers) {
+			schedulerWakeAll(&pipe->writeWaiters);
+			pollNotify(pipe->writeWatchers, POLL_WRITABLE | POLL_HANGUP);
+		}
+	}
+
+	unsigned char unused = !pipe->readers && !pipe->writers;
+
+	spinlockRelease(&pipe->lock);
+
+	if (unused) {
+		free(pipe->buffer);
+		free(pipe);
+	}
+}
+
+/**
+ * Take up to length bytes out of the buffer into dest, the lock must be held. Returns how many were taken
+ */
+static unsigned int pipeTake(pipe_t* pipe, uint8_t* dest, unsigned int length) {
+	unsigned int taken = length < pipe->used ? length : pipe->used;
+
+	//At most two pieces, up to the end of the buffer and then from its start
+	unsigned int first = PIPE_BUFFER_SIZE - pipe->head;
+
+	if (first > taken) {
+		first = taken;
+	}
+
+	memcpy(dest, pipe->buffer + pipe->head, first);
+	memcpy(dest + first, pipe->buffer, taken - first);
+
+	pipe->head = (pipe->head + taken) % PIPE_BUFFER_SIZE;
+	pipe->used -= taken;
+
+	if (!processQueueEmpty(&pipe->writeWaiters)) {
+		schedulerWakeAll(&pipe->writeWaiters);
+	}
+
+	pollNotify(pipe->writeWatchers, POLL_WRITABLE);
+	return taken;
+}
+
+int pipeRead(pipe_t* pipe, uint8_t* dest, unsigned int length, unsigned char nonblocking) {
+	uint8_t chunk[PIPE_COPY_CHUNK];
+	unsigned int copied = 0;
+
+	spinlockAcquire(&pipe->lock);
+
+	while (!pipe->used) {
+
+		if (!pipe->writers) {
+			spinlockRelease(&pipe->lock);
+			return 0;
+		}
+
+		if (nonblocking) {
+			spinlockRelease(&pipe->lock);
+			return HANDLE_ERROR_WOULD_BLOCK;
+		}
+
+		schedulerBlock(&pipe->readWaiters, &pipe->lock);
+	}
+
+	//Whatever is there is read, a chunk at a time so a bad dest faults with the lock dropped
+	while (copied < length && pipe->used) {
+		unsigned int taken = pipeTake(pipe, chunk, length - copied < PIPE_COPY_CHUNK ? length - copied : PIPE_COPY_CHUNK);
+
+		spinlockRelease(&pipe->lock);
+		memcpy(dest + copied, chunk, taken);
+		copied += taken;
+		spinlockAcquire(&pipe->lock);
+	}
+
+	spinlockRelease(&pipe->lock);
+	return copied;
+}
+
+/**
+ * Put length bytes from src into the buffer, sleeping whenever it is full unless nonblocking is set. The lock must be
+ * held and is held again on return. Returns how many were put in, less than length if the pipe filled up (when
+ * nonblocking) or every read end was closed
+ */
+static unsigned int pipePut(pipe_t* pipe, const uint8_t* src, unsigned int length, unsigned char nonblocking) {
+	unsigned int put = 0;
+
+	while (put < length) {
+
+		if (!pipe->readers) {
+			break;
+		}
+
+		if (pipe->used == PIPE_BUFFER_SIZE) {
+
+			if (nonblocking) {
+				break;
+			}
+
+			schedulerBlock(&pipe->writeWaiters, &pipe->lock);
+			continue;
+		}
+
+		unsigned int tail = (pipe->head + pipe->used) % PIPE_BUFFER_SIZE;
+		unsigned int room = PIPE_BUFFER_SIZE - pipe->used;
+
+		//Only up to the end of the buffer, the rest goes in on the next time round
+		if (room > PIPE_BUFFER_SIZE - tail) {
+			room = PIPE_BUFFER_SIZE - tail;
+		}
+
+		unsigned int piece = length - put < room ? length - put : room;
+
+		memcpy(pipe->buffer + tail, (void*) (src + put), piece);
+		pipe->used += piece;
+		put += piece;
+
+		if (!processQueueEmpty(&pipe->readWaiters)) {
+			schedulerWakeAll(&pipe->readWaiters);
+		}
+
+		pollNotify(pipe->readWatchers, POLL_READABLE);
+	}
+
+	return put;
+}
+
+int pipeWrite(pipe_t* pipe, const uint8_t* src, unsigned int length, unsigned char nonblocking) {
+	uint8_t chunk[PIPE_COPY_CHUNK];
+	unsigned int written = 0;
+	unsigned char closed = 0;
+
+	while (written < length) {
+		unsigned int size = length - written < PIPE_COPY_CHUNK ? length - written : PIPE_COPY_CHUNK;
+
+		//A bad src faults here, before the lock is taken
+		memcpy(chunk, (void*) (src + written), size);
+
+		spinlockAcquire(&pipe->lock);
+		unsigned int put = pipePut(pipe, chunk, size, nonblocking);
+		closed = !pipe->readers;
+		spinlockRelease(&pipe->lock);
+
+		written += put;
+
+		if (put != size) {
+			break;
+		}
+	}
+
+	if (!written && length) {
+		return closed ? HANDLE_ERROR_CLOSED : HANDLE_ERROR_WOULD_BLOCK;
+	}
+
+	return written;
+}
+
+void pipeWatch(pipe_t* pipe, poll_watch_t* watch, unsigned char writeEnd) {
+	spinlockAcquire(&pipe->lock);
+
+	//Whatever the end is ready for already is reported once straight away
+	if (writeEnd) {
+		pollWatchAdd(&pipe->writeWatchers, watch);
+		pollSignal(watch, (pipe->used < PIPE_BUFFER_SIZE ? POLL_WRITABLE : 0) | (!pipe->readers ? POLL_HANGUP : 0));
+	} else {
+		pollWatchAdd(&pipe->readWatchers, watch);
+		pollSignal(watch, (pipe->used ? POLL_READABLE : 0) | (!pipe->writers ? POLL_READABLE | POLL_HANGUP : 0));
+	}
+
+	spinlockRelease(&pipe->lock);
+}
+
+void pipeUnwatch(pipe_t* pipe, poll_watch_t* watch, unsigned char writeEnd) {
+	spinlockAcquire(&pipe->lock);
+	pollWatchRemove(writeEnd ? &pipe->writeWatchers : &pipe->readWatchers, watch);
+	spinlockRelease(&pipe->lock);
+}
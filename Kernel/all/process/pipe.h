@@ -0,0 +1,51 @@
+#ifndef _PROCESS_PIPE_DEF_H_
+#define _PROCESS_PIPE_DEF_H_
+#include <syscall/syscall_handles.h>
+#include <process/poll.h>
+#include <types/stdint.h>
+
+/**
+ * The number of bytes a pipe holds before writers have to wait for it to be read
+ */
+#define PIPE_BUFFER_SIZE 0x4000
+
+/**
+ * A byte stream between processes through a ring buffer in the kernel. The pipe counts the handles open on each end
+ * and is freed once the last of them is closed
+ */
+typedef struct pipe pipe_t;
+
+/**
+ * Create a pipe with one read end and one write end open, returns 0 if there isn't the memory for it
+ */
+pipe_t* pipeCreate();
+
+/**
+ * Open another handle on / close a handle on one end of the pipe. Closing the last write end lets readers see the end
+ * of the stream and closing the last read end fails writers
+ */
+void pipeOpenEnd(pipe_t* pipe, unsigned char writeEnd);
+void pipeCloseEnd(pipe_t* pipe, unsigned char writeEnd);
+
+/**
+ * Copy up to length bytes out of the pipe into dest, sleeping untill there is something to read unless nonblocking is
+ * set. Returns the number of bytes read, 0 at the end of the stream or HANDLE_ERROR_WOULD_BLOCK
+ */
+int pipeRead(pipe_t* pipe, uint8_t* dest, unsigned int length, unsigned char nonblocking);
+
+/**
+ * Copy length bytes from src into the pipe, sleeping whenever it is full unless nonblocking is set (then only what
+ * fits is written). Returns the number of bytes written, HANDLE_ERROR_WOULD_BLOCK or HANDLE_ERROR_CLOSED if nothing
+ * could be
+ */
+int pipeWrite(pipe_t* pipe, const uint8_t* src, unsigned int length, unsigned char nonblocking);
+
+/**
+ * Add / remove a poll watch on one end of the pipe. The read end reports POLL_READABLE as data is written (or the
+ * last write end closes) and the write end POLL_WRITABLE as data is read, either reports POLL_HANGUP once the other
+ * end is closed everywhere. A new watch is signalled straight away with whatever the end is already ready for
+ */
+void pipeWatch(pipe_t* pipe, poll_watch_t* watch, unsigned char writeEnd);
+void pipeUnwatch(pipe_t* pipe, poll_watch_t* watch, unsigned char writeEnd);
+
+#endif //_PROCESS_PIPE_DEF_H_
@@ -0,0 +1,470 @@
+#include <process/poll.h>
+#include <process/pipe.h>
+#include <process/process.h>
+#include <process/process_queue.h>
+#include <scheduler/scheduler.h>
+#include <clock/clock.h>
+#include <lock/spinlock.h>
+#include <stdlib.h>
+
+typedef struct {
+	unsigned char used;
+	uint32_t source;
+	uint32_t id;
+	uint32_t userData;
+
+	/**
+	 * The events that happened since the registration was last reported, and whether it is on the ready list.
+	 * readyNext and timerNext are the number (plus one) of the next registration on the ready and timer lists
+	 */
+	uint32_t pending;
+	unsigned char queued;
+	unsigned int readyNext;
+	unsigned int timerNext;
+
+	/**
+	 * Timers expire every period ticks, next at deadline
+	 */
+	unsigned long period;
+	unsigned long deadline;
+
+	/**
+	 * The pipe and the end of it a handle registration watches
+	 */
+	pipe_t* pipe;
+	unsigned char writeEnd;
+
+	poll_watch_t watch;
+} poll_registration_t;
+
+struct poll_set {
+	poll_registration_t registrations[POLL_MAX_REGISTRATIONS];
+
+	/**
+	 * The number (plus one) of the oldest and newest ready registrations and of the timer that expires next, the
+	 * timer list is kept in the order they expire
+	 */
+	unsigned int readyHead;
+	unsigned int readyTail;
+	unsigned int timers;
+
+	//Taken with interrupts disabled as postboxes are pushed to from interrupt handlers
+	spinlock_t lock;
+
+	/**
+	 * Threads blocked in pollWait
+	 */
+	process_queue_t waiters;
+};
+
+void pollWatchAdd(poll_watch_t** watchers, poll_watch_t* watch) {
+	watch->next = *watchers;
+	*watchers = watch;
+}
+
+void pollWatchRemove(poll_watch_t** watchers, poll_watch_t* watch) {
+
+	for (poll_watch_t** iterator = watchers; *iterator; iterator = &(*iterator)->next) {
+		if (*iterator == watch) {
+			*iterator = watch->next;
+			return;
+		}
+	}
+}
+
+/**
+ * Add the events to the registration, putting it on the ready list if it isn't already. set->lock must be held
+ */
+static void pollQueueLocked(poll_set_t* set, unsigned int slot, uint32_t events) {
+	poll_registration_t* registration = &set->registrations[slot];
+
+	registration->pending |= events;
+
+	if (registration->queued) {
+		return;
+	}
+
+	registration->queued = 1;
+	registration->readyNext = 0;
+
+	if (set->readyTail) {
+		set->registrations[set->readyTail - 1].readyNext = slot + 1;
+	} else {
+		set->readyHead = slot + 1;
+	}
+
+	set->readyTail = slot + 1;
+
+	//Checked first so a source becoming ready while nobody waits never touches the scheduler lock
+	if (!processQueueEmpty(&set->waiters)) {
+		schedulerWakeOne(&set->waiters);
+	}
+}
+
+void pollSignal(poll_watch_t* watch, uint32_t events) {
+	events &= watch->events;
+
+	if (!events) {
+		return;
+	}
+
+	irq_flags_t flags = spinlockAcquireIrqSave(&watch->set->lock);
+	pollQueueLocked(watch->set, watch->slot, events);
+	spinlockReleaseIrqRestore(&watch->set->lock, flags);
+}
+
+void pollNotify(poll_watch_t* watchers, uint32_t events) {
+	for (; watchers; watchers = watchers->next) {
+		pollSignal(watchers, events);
+	}
+}
+
+/**
+ * Put the timer on the timer list in the order it expires. set->lock must be held
+ */
+static void pollTimerInsertLocked(poll_set_t* set, unsigned int slot) {
+	unsigned int* iterator = &set->timers;
+
+	while (*iterator && set->registrations[*iterator - 1].deadline <= set->registrations[slot].deadline) {
+		iterator = &set->registrations[*iterator - 1].timerNext;
+	}
+
+	set->registrations[slot].timerNext = *iterator;
+	*iterator = slot + 1;
+}
+
+/**
+ * Report every timer that has expired by now and set it to expire again. set->lock must be held
+ */
+static void pollTimersExpireLocked(poll_set_t* set, unsigned long now) {
+
+	while (set->timers && set->registrations[set->timers - 1].deadline <= now) {
+		unsigned int slot = set->timers - 1;
+		poll_registration_t* timer = &set->registrations[slot];
+
+		set->timers = timer->timerNext;
+		pollQueueLocked(set, slot, POLL_EXPIRED);
+
+		//Expiries missed while nobody waited are only reported once
+		timer->deadline += timer->period;
+
+		if (timer->deadline <= now) {
+			timer->deadline = now + timer->period;
+		}
+
+		pollTimerInsertLocked(set, slot);
+	}
+}
+
+/**
+ * Returns the poll set of the leader given, creating it if it has none. Its handleLock must be held
+ */
+static poll_set_t* pollSetOf(process_t* leader) {
+
+	if (!leader->pollSet) {
+		poll_set_t* set = malloc(sizeof(poll_set_t));
+		memset(set, 0, sizeof(poll_set_t));
+		spinlockInit(&set->lock, "poll set");
+		leader->pollSet = set;
+	}
+
+	return leader->pollSet;
+}
+
+int pollAdd(uint32_t source, uint32_t id, uint32_t events, uint32_t userData) {
+	process_t* current = getCurrentProcess();
+	process_t* leader = processLeader(current);
+
+	if (source > POLL_SOURCE_RING || (source == POLL_SOURCE_TIMER && !id)) {
+		return POLL_ERROR_BAD;
+	}
+
+	//Registrations only change with the handleLock held, so a handle can't be closed while one is made on it
+	spinlockAcquire(&leader->handleLock);
+
+	handle_t handle = { 0, 0, 0 };
+
+	if (source == POLL_SOURCE_HANDLE) {
+
+		if (id < PROCESS_MAX_HANDLES) {
+			handle = leader->handles[id];
+		}
+
+		if (!handle.pipe) {
+			spinlockRelease(&leader->handleLock);
+			return POLL_ERROR_BAD;
+		}
+	}
+
+	poll_set_t* set = pollSetOf(leader);
+
+	irq_flags_t flags = spinlockAcquireIrqSave(&set->lock);
+
+	int slot = POLL_ERROR_FULL;
+
+	for (unsigned int i = 0; i < POLL_MAX_REGISTRATIONS; i++) {
+		if (!set->registrations[i].used) {
+			slot = i;
+			break;
+		}
+	}
+
+	//A thread only has one ring, a second registration on it would never hear anything
+	if (source == POLL_SOURCE_RING && current->ringPoll) {
+		poll_registration_t* existing = &set->registrations[current->ringPoll - 1];
+
+		if (existing->used && existing->source == POLL_SOURCE_RING && existing->id == current->id) {
+			slot = POLL_ERROR_BAD;
+		}
+	}
+
+	if (slot < 0) {
+		spinlockReleaseIrqRestore(&set->lock, flags);
+		spinlockRelease(&leader->handleLock);
+		return slot;
+	}
+
+	poll_registration_t* registration = &set->registrations[slot];
+	memset(registration, 0, sizeof(poll_registration_t));
+
+	registration->used = 1;
+	registration->source = source;
+	registration->id = id;
+	registration->userData = userData;
+	registration->watch.set = set;
+	registration->watch.slot = slot;
+
+	switch (source) {
+	case POLL_SOURCE_POSTBOX:
+		registration->watch.events = events & POLL_READABLE;
+		break;
+	case POLL_SOURCE_HANDLE:
+		registration->pipe = handle.pipe;
+		registration->writeEnd = handle.writeEnd;
+		registration->watch.events = events & (POLL_HANGUP | (handle.writeEnd ? POLL_WRITABLE : POLL_READABLE));
+		break;
+	case POLL_SOURCE_TIMER:
+		registration->period = id;
+		registration->deadline = getClockTicks() + id;
+		pollTimerInsertLocked(set, slot);
+
+		//A thread already waiting may have to wake up sooner than it planned
+		if (!processQueueEmpty(&set->waiters)) {
+			schedulerWakeOne(&set->waiters);
+		}
+
+		break;
+	case POLL_SOURCE_RING:
+		registration->id = current->id;
+		current->ringPoll = slot + 1;
+		break;
+	}
+
+	spinlockReleaseIrqRestore(&set->lock, flags);
+
+	//Sources are attached without the set lock held, they take it to signal
+	if (source == POLL_SOURCE_POSTBOX) {
+		postboxWatch(&leader->processPostbox, &registration->watch);
+	} else if (source == POLL_SOURCE_HANDLE) {
+		pipeWatch(handle.pipe, &registration->watch, handle.writeEnd);
+	}
+
+	spinlockRelease(&leader->handleLock);
+	return slot;
+}
+
+/**
+ * Detach the registration from its source and free it. The handleLock of the leader must be held
+ */
+static void pollUnregister(process_t* leader, poll_set_t* set, unsigned int slot) {
+	poll_registration_t* registration = &set->registrations[slot];
+
+	if (registration->source == POLL_SOURCE_POSTBOX) {
+		postboxUnwatch(&leader->processPostbox, &registration->watch);
+	} else if (registration->source == POLL_SOURCE_HANDLE) {
+		pipeUnwatch(registration->pipe, &registration->watch, registration->writeEnd);
+	}
+
+	//Once off its source nothing can signal it, only the lists of the set refer to it
+	irq_flags_t flags = spinlockAcquireIrqSave(&set->lock);
+
+	if (registration->queued) {
+		unsigned int previous = 0;
+
+		for (unsigned int iterator = set->readyHead; iterator != slot + 1;
+				iterator = set->registrations[iterator - 1].readyNext) {
+			previous = iterator;
+		}
+
+		if (previous) {
+			set->registrations[previous - 1].readyNext = registration->readyNext;
+		} else {
+			set->readyHead = registration->readyNext;
+		}
+
+		if (set->readyTail == slot + 1) {
+			set->readyTail = previous;
+		}
+	}
+
+	if (registration->source == POLL_SOURCE_TIMER) {
+		unsigned int* iterator = &set->timers;
+
+		while (*iterator != slot + 1) {
+			iterator = &set->registrations[*iterator - 1].timerNext;
+		}
+
+		*iterator = registration->timerNext;
+	}
+
+	registration->used = 0;
+
+	spinlockReleaseIrqRestore(&set->lock, flags);
+}
+
+int pollRemove(int registration) {
+	process_t* leader = processLeader(getCurrentProcess());
+	int result = POLL_ERROR_BAD;
+
+	spinlockAcquire(&leader->handleLock);
+
+	poll_set_t* set = leader->pollSet;
+
+	if (set && registration >= 0 && registration < POLL_MAX_REGISTRATIONS && set->registrations[registration].used) {
+		pollUnregister(leader, set, registration);
+		result = 0;
+	}
+
+	spinlockRelease(&leader->handleLock);
+	return result;
+}
+
+int pollWait(poll_event_t* events, unsigned int max, unsigned long ticks) {
+	process_t* leader = processLeader(getCurrentProcess());
+	poll_event_t ready[POLL_MAX_REGISTRATIONS];
+
+	spinlockAcquire(&leader->handleLock);
+	poll_set_t* set = pollSetOf(leader);
+	spinlockRelease(&leader->handleLock);
+
+	//Every registration is on the ready list at most once
+	if (max > POLL_MAX_REGISTRATIONS) {
+		max = POLL_MAX_REGISTRATIONS;
+	}
+
+	unsigned long deadline = getClockTicks() + ticks;
+
+	irq_flags_t flags = spinlockAcquireIrqSave(&set->lock);
+
+	for (;;) {
+		unsigned long now = getClockTicks();
+		pollTimersExpireLocked(set, now);
+
+		if (set->readyHead) {
+			break;
+		}
+
+		//Sleep untill the deadline or the next timer, whichever comes first
+		unsigned long remaining = 0;
+
+		if (ticks) {
+
+			if (now >= deadline) {
+				break;
+			}
+
+			remaining = deadline - now;
+		}
+
+		if (set->timers) {
+			unsigned long untilTimer = set->registrations[set->timers - 1].deadline - now;
+
+			if (!remaining || untilTimer < remaining) {
+				remaining = untilTimer;
+			}
+		}
+
+		schedulerBlockTimeout(&set->waiters, &set->lock, remaining);
+	}
+
+	unsigned int copied = 0;
+
+	while (set->readyHead && copied < max) {
+		poll_registration_t* registration = &set->registrations[set->readyHead - 1];
+
+		set->readyHead = registration->readyNext;
+
+		if (!set->readyHead) {
+			set->readyTail = 0;
+		}
+
+		ready[copied].userData = registration->userData;
+		ready[copied].events = registration->pending;
+		copied++;
+
+		registration->pending = 0;
+		registration->queued = 0;
+	}
+
+	//Another thread can have whatever didn't fit
+	if (set->readyHead && !processQueueEmpty(&set->waiters)) {
+		schedulerWakeOne(&set->waiters);
+	}
+
+	spinlockReleaseIrqRestore(&set->lock, flags);
+
+	memcpy(events, ready, copied * sizeof(poll_event_t));
+	return copied;
+}
+
+void pollHandleClosed(process_t* leader, int handle) {
+	poll_set_t* set = leader->pollSet;
+
+	if (!set) {
+		return;
+	}
+
+	for (unsigned int i = 0; i < POLL_MAX_REGISTRATIONS; i++) {
+		poll_registration_t* registration = &set->registrations[i];
+
+		if (registration->used && registration->source == POLL_SOURCE_HANDLE && registration->id == (uint32_t) handle) {
+			pollUnregister(leader, set, i);
+		}
+	}
+}
+
+void pollRingCompleted(process_t* thread) {
+	poll_set_t* set = processLeader(thread)->pollSet;
+
+	if (!set || !thread->ringPoll) {
+		return;
+	}
+
+	irq_flags_t flags = spinlockAcquireIrqSave(&set->lock);
+
+	//The registration may have been removed (and the slot reused) since the thread recorded it
+	poll_registration_t* registration = &set->registrations[thread->ringPoll - 1];
+
+	if (registration->used && registration->source == POLL_SOURCE_RING && registration->id == thread->id) {
+		pollQueueLocked(set, thread->ringPoll - 1, POLL_COMPLETED);
+	}
+
+	spinlockReleaseIrqRestore(&set->lock, flags);
+}
+
+void pollFree(process_t* leader) {
+	poll_set_t* set = leader->pollSet;
+
+	if (!set) {
+		return;
+	}
+
+	for (unsigned int i = 0; i < POLL_MAX_REGISTRATIONS; i++) {
+		if (set->registrations[i].used) {
+			pollUnregister(leader, set, i);
+		}
+	}
+
+	leader->pollSet = 0;
+	free(set);
+}
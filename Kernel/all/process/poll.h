@@ -0,0 +1,71 @@
+#ifndef _PROCESS_POLL_DEF_H_
+#define _PROCESS_POLL_DEF_H_
+#include <syscall/syscall_poll.h>
+#include <types/stdint.h>
+
+struct processStructure;
+
+/**
+ * Every process has a poll set (in its leader, created by the first registration) holding the sources it is
+ * interested in and a list of the ones that have become ready since it last waited
+ */
+typedef struct poll_set poll_set_t;
+
+/**
+ * Links a registration into the list kept by the source it watches, so the source only has to look at whoever is
+ * interested in it when something happens. events are the POLL_ events the registration wants to hear about
+ */
+typedef struct poll_watch {
+	poll_set_t* set;
+	unsigned int slot;
+	uint32_t events;
+	struct poll_watch* next;
+} poll_watch_t;
+
+/**
+ * Add a watch to / remove a watch from the list kept by a source, with the lock of the source held
+ */
+void pollWatchAdd(poll_watch_t** watchers, poll_watch_t* watch);
+void pollWatchRemove(poll_watch_t** watchers, poll_watch_t* watch);
+
+/**
+ * Mark the registration behind a watch (or every watch on the list given) ready with whichever of the events it
+ * is interested in, waking a thread waiting on its set. The lock of the source the watches are on must be held
+ */
+void pollSignal(poll_watch_t* watch, uint32_t events);
+void pollNotify(poll_watch_t* watchers, uint32_t events);
+
+/**
+ * Syscall - register interest in a source (one of the POLL_SOURCE_ with the id it takes) with the poll set of the
+ * current process, to be reported with userData. Returns the number of the registration or a POLL_ERROR
+ */
+int pollAdd(uint32_t source, uint32_t id, uint32_t events, uint32_t userData);
+
+/**
+ * Syscall - remove a registration returned by pollAdd, returns 0 or POLL_ERROR_BAD
+ */
+int pollRemove(int registration);
+
+/**
+ * Syscall - block untill a registered source is ready or the given number of clock ticks pass (0 waits forever),
+ * then copy up to max ready sources to events. Returns the number copied, 0 if it timed out
+ */
+int pollWait(poll_event_t* events, unsigned int max, unsigned long ticks);
+
+/**
+ * Called as a handle of the leader given is closed (with its handleLock held), drops the registrations on it
+ */
+void pollHandleClosed(struct processStructure* leader, int handle);
+
+/**
+ * Called once the syscall ring of the thread given has written completions
+ */
+void pollRingCompleted(struct processStructure* thread);
+
+/**
+ * Drop every registration of the leader given and free its poll set, called with its handleLock held once the
+ * process and all of its threads have exited
+ */
+void pollFree(struct processStructure* leader);
+
+#endif //_PROCESS_POLL_DEF_H_
@@ -6,66 +6,328 @@
  */
 
 #include <process/postbox.h>
+#include <process/grant.h>
+#include <mm/virtual.h>
+#include <scheduler/scheduler.h>
+#include <clock/clock.h>
 #include <stdlib.h>
 
 unsigned char postboxEmpty(process_postbox* pb) {
-	return pb->first == 0;
+	return pb->count == 0;
+}
+
+static unsigned int postboxLimit(process_postbox* pb) {
+	return pb->limit ? pb->limit : POSTBOX_DEFAULT_LIMIT;
+}
+
+/**
+ * Let a sender waiting for room know a message has been popped, pb->lock must be held
+ */
+static void postboxWakeSender(process_postbox* pb) {
+
+	//Checked first so a pop nobody is waiting on never touches the scheduler lock
+	if (!processQueueEmpty(&pb->senders)) {
+		schedulerWakeOne(&pb->senders);
+	}
 }
 
 process_message* postboxTop(process_postbox* pb, process_message* dest) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&pb->lock);
 
-	if (!pb->first) {
+	if (!pb->count) {
+		spinlockReleaseIrqRestore(&pb->lock, flags);
 		return 0;
 	}
 
-	postbox_message_entry* message = pb->first;
+	*dest = pb->slots[pb->head];
 
-	//Update the linked list head
-	if (pb->first->next != 0) {
-		pb->first = message->next;
-	} else {
-		pb->first = 0;
-	}
+	pb->head = pb->head + 1 == pb->capacity ? 0 : pb->head + 1;
+	pb->count--;
 
-	*dest = message->data;
-	free(message);
+	postboxWakeSender(pb);
 
+	spinlockReleaseIrqRestore(&pb->lock, flags);
 	return dest;
 }
 
+unsigned int postboxTopBatch(process_postbox* pb, process_message* dest, unsigned int max) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&pb->lock);
+
+	unsigned int copied = pb->count < max ? pb->count : max;
+
+	for (unsigned int i = 0; i < copied; i++) {
+		dest[i] = pb->slots[pb->head];
+		pb->head = pb->head + 1 == pb->capacity ? 0 : pb->head + 1;
+	}
+
+	pb->count -= copied;
+
+	for (unsigned int i = 0; i < copied; i++) {
+		postboxWakeSender(pb);
+	}
+
+	spinlockReleaseIrqRestore(&pb->lock, flags);
+	return copied;
+}
+
 process_message* postboxPeek(process_postbox* pb, process_message* dest) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&pb->lock);
 
-	if (!pb->first) {
+	if (!pb->count) {
+		spinlockReleaseIrqRestore(&pb->lock, flags);
 		return 0;
 	}
 
-	*dest = pb->first->data;
+	*dest = pb->slots[pb->head];
+	spinlockReleaseIrqRestore(&pb->lock, flags);
 	return dest;
 }
 
-void postboxPush(process_postbox* pb, process_message* msg) {
+/**
+ * Move the messages in the postbox over to the larger ring given (of newCapacity slots), returning the old slots to
+ * be freed. pb->lock must be held
+ */
+static process_message* postboxResize(process_postbox* pb, process_message* slots, unsigned int newCapacity) {
+
+	//Unwrap the ring so the oldest message is in the first slot
+	for (unsigned int i = 0, slot = pb->head; i < pb->count; i++) {
+		slots[i] = pb->slots[slot];
+		slot = slot + 1 == pb->capacity ? 0 : slot + 1;
+	}
+
+	process_message* old = pb->slots;
+
+	pb->slots = slots;
+	pb->capacity = newCapacity;
+	pb->head = 0;
+	pb->tail = pb->count;
+
+	return old;
+}
+
+static unsigned char postboxPushInternal(process_postbox* pb, process_message* msg, unsigned char canBlock) {
+	process_message evicted;
+	unsigned char hasEvicted = 0;
+	unsigned char queued = 0;
+
+	irq_flags_t flags = spinlockAcquireIrqSave(&pb->lock);
 
-	//If there is no head then create a new list
-	if (pb->first == 0) {
-		postbox_message_entry* new_entry = malloc(
-				sizeof(postbox_message_entry));
-		new_entry->data = *msg;
-		new_entry->next = 0;
+	while (!pb->closed) {
 
-		pb->first = new_entry;
-	} else {
-		//Add to the end of the list
-		postbox_message_entry* last = pb->first;
+		if (pb->count >= postboxLimit(pb)) {
 
-		//Find the last entry
-		while (last->next) {
-			last = last->next;
+			if (pb->policy == POSTBOX_BLOCK_SENDER && canBlock) {
+				pb->blockedSenders++;
+				schedulerBlock(&pb->senders, &pb->lock);
+				pb->blockedSenders--;
+				continue;
+			}
+
+			if (pb->policy != POSTBOX_DROP_OLDEST || !pb->count) {
+				break;
+			}
+
+			//Make room by dropping the oldest message, its grant is freed once the lock is dropped
+			if (hasEvicted) {
+				spinlockReleaseIrqRestore(&pb->lock, flags);
+				grantDiscard(&evicted);
+				hasEvicted = 0;
+				flags = spinlockAcquireIrqSave(&pb->lock);
+				continue;
+			}
+
+			evicted = pb->slots[pb->head];
+			hasEvicted = 1;
+
+			pb->head = pb->head + 1 == pb->capacity ? 0 : pb->head + 1;
+			pb->count--;
+			pb->dropped++;
+			continue;
 		}
 
-		postbox_message_entry* new_entry = malloc(sizeof(postbox_message_entry));
-		new_entry->data = *msg;
-		new_entry->next = 0;
-		last->next = new_entry;
+		if (pb->count == pb->capacity) {
+
+			//Allocate outside the lock so it is held as briefly as possible, the ring may have changed by the time it
+			//is taken again
+			unsigned int size = PAGE_SIZE;
+
+			while (size / sizeof(process_message) <= pb->capacity) {
+				size *= 2;
+			}
+
+			spinlockReleaseIrqRestore(&pb->lock, flags);
+
+			process_message* slots = malloc(size);
+
+			flags = spinlockAcquireIrqSave(&pb->lock);
+
+			//Out of memory, the message is dropped like one pushed to a full postbox
+			if (!slots) {
+				break;
+			}
+
+			if (pb->count == pb->capacity && size / sizeof(process_message) > pb->capacity) {
+				slots = postboxResize(pb, slots, size / sizeof(process_message));
+			}
+
+			if (slots) {
+				spinlockReleaseIrqRestore(&pb->lock, flags);
+				free(slots);
+				flags = spinlockAcquireIrqSave(&pb->lock);
+			}
+
+			continue;
+		}
+
+		pb->slots[pb->tail] = *msg;
+
+		pb->tail = pb->tail + 1 == pb->capacity ? 0 : pb->tail + 1;
+		pb->count++;
+		pb->enqueued++;
+
+		if (pb->count > pb->highWater) {
+			pb->highWater = pb->count;
+		}
+
+		//Checked first so a push nobody is waiting for never touches the scheduler lock
+		if (!processQueueEmpty(&pb->waiters)) {
+			schedulerWakeOne(&pb->waiters);
+		}
+
+		pollNotify(pb->watchers, POLL_READABLE);
+
+		queued = 1;
+		break;
 	}
+
+	if (!queued) {
+		pb->dropped++;
+	}
+
+	spinlockReleaseIrqRestore(&pb->lock, flags);
+
+	if (hasEvicted) {
+		grantDiscard(&evicted);
+	}
+
+	return queued;
+}
+
+unsigned char postboxPush(process_postbox* pb, process_message* msg) {
+	return postboxPushInternal(pb, msg, 0);
+}
+
+unsigned char postboxPushWait(process_postbox* pb, process_message* msg) {
+	return postboxPushInternal(pb, msg, 1);
+}
+
+void postboxSetLimit(process_postbox* pb, unsigned int limit, unsigned char policy) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&pb->lock);
+
+	pb->limit = limit > POSTBOX_MAX_LIMIT ? POSTBOX_MAX_LIMIT : limit;
+	pb->policy = policy;
+
+	//Senders waiting for room may not have to any more
+	if (policy != POSTBOX_BLOCK_SENDER || pb->count < postboxLimit(pb)) {
+		schedulerWakeAll(&pb->senders);
+	}
+
+	spinlockReleaseIrqRestore(&pb->lock, flags);
+}
+
+void postboxFillInfo(process_postbox* pb, process_info_t* info) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&pb->lock);
+
+	info->postboxQueued = pb->count;
+	info->postboxHighWater = pb->highWater;
+	info->postboxEnqueued = pb->enqueued;
+	info->postboxDropped = pb->dropped;
+
+	spinlockReleaseIrqRestore(&pb->lock, flags);
+}
+
+void postboxWatch(process_postbox* pb, poll_watch_t* watch) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&pb->lock);
+
+	pollWatchAdd(&pb->watchers, watch);
+
+	if (pb->count) {
+		pollSignal(watch, POLL_READABLE);
+	}
+
+	spinlockReleaseIrqRestore(&pb->lock, flags);
+}
+
+void postboxUnwatch(process_postbox* pb, poll_watch_t* watch) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&pb->lock);
+	pollWatchRemove(&pb->watchers, watch);
+	spinlockReleaseIrqRestore(&pb->lock, flags);
 }
 
+unsigned char postboxWaitForMessage(process_postbox* pb, unsigned long ticks) {
+	unsigned long deadline = getClockTicks() + ticks;
+
+	irq_flags_t flags = spinlockAcquireIrqSave(&pb->lock);
+
+	while (!pb->count) {
+		unsigned long remaining = 0;
+
+		//Another thread of the process can take the message it was woken for, it then waits out what is left
+		if (ticks) {
+			unsigned long now = getClockTicks();
+
+			if (now >= deadline) {
+				break;
+			}
+
+			remaining = deadline - now;
+		}
+
+		if (!schedulerBlockTimeout(&pb->waiters, &pb->lock, remaining)) {
+			break;
+		}
+	}
+
+	unsigned char waiting = pb->count != 0;
+
+	spinlockReleaseIrqRestore(&pb->lock, flags);
+	return waiting;
+}
+
+void postboxFree(process_postbox* pb) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&pb->lock);
+
+	//Blocked senders give up once they see the postbox closed, it can't be freed from under them
+	pb->closed = 1;
+
+	while (pb->blockedSenders) {
+		schedulerWakeAll(&pb->senders);
+
+		spinlockReleaseIrqRestore(&pb->lock, flags);
+		schedulerYield();
+		flags = spinlockAcquireIrqSave(&pb->lock);
+	}
+
+	process_message* slots = pb->slots;
+	unsigned int head = pb->head;
+	unsigned int count = pb->count;
+	unsigned int capacity = pb->capacity;
+
+	pb->slots = 0;
+	pb->capacity = 0;
+	pb->head = 0;
+	pb->tail = 0;
+	pb->count = 0;
+
+	spinlockReleaseIrqRestore(&pb->lock, flags);
+
+	//Nobody is going to read the pages granted with what was left
+	for (unsigned int i = 0; i < count; i++) {
+		grantDiscard(&slots[head]);
+		head = head + 1 == capacity ? 0 : head + 1;
+	}
+
+	if (slots) {
+		free(slots);
+	}
+}
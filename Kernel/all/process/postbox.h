@@ -1,18 +1,63 @@
 #ifndef _PROCESS_POSTBOX_DEF_H_
 #define _PROCESS_POSTBOX_DEF_H_
 #include <process/message.h>
+#include <lock/spinlock.h>
+#include <process/process_queue.h>
+#include <process/process_info.h>
+#include <process/poll.h>
 
-struct process_postbox_message {
-	process_message data;
-	struct process_postbox_message* next; //The next entry
-};
-
-//Another approach would be just to skip the process_postbox structure and use first as a pointer in process. Don't know why I picked this route, makes almost no difference
+/**
+ * A postbox is a ring of message slots, read by the process that owns it and written to by anyone (other CPUs and
+ * interrupt handlers included). Pushing and popping copy a single message without allocating, the ring only grows
+ * (a page at a time, doubling) when a push finds it full and it holds fewer messages than its limit. Once it is at
+ * its limit the policy decides what gets dropped. A zeroed postbox is empty with no slots and the default limit
+ */
 typedef struct {
-	struct process_postbox_message* first;
-} process_postbox;
+	process_message* slots;
+	unsigned int capacity;
+
+	/**
+	 * The slot of the oldest message, the slot the next message goes in and the number of messages waiting
+	 */
+	unsigned int head;
+	unsigned int tail;
+	unsigned int count;
+
+	//Taken with interrupts disabled and only ever held to copy a message in or out (or the ring when it grows)
+	spinlock_t lock;
+
+	/**
+	 * Processes blocked in postboxWaitForMessage, every push wakes one of them
+	 */
+	process_queue_t waiters;
+
+	/**
+	 * The most messages the postbox holds (0 for POSTBOX_DEFAULT_LIMIT) and one of the POSTBOX_ policies for what
+	 * happens to a message pushed once it does
+	 */
+	unsigned int limit;
+	unsigned char policy;
 
-typedef struct process_postbox_message postbox_message_entry;
+	/**
+	 * Messages pushed, messages dropped because the postbox was full and the most it has held at once
+	 */
+	unsigned long enqueued;
+	unsigned long dropped;
+	unsigned int highWater;
+
+	/**
+	 * Senders sleeping untill there is room (with POSTBOX_BLOCK_SENDER), every pop wakes one of them. Once the postbox
+	 * is closed they give up and it isn't freed untill the last of them has left
+	 */
+	process_queue_t senders;
+	unsigned int blockedSenders;
+	unsigned char closed;
+
+	/**
+	 * Poll registrations told about every message pushed
+	 */
+	poll_watch_t* watchers;
+} process_postbox;
 
 /**
  * Returns 1 if the postbox is empty, 0 otherwise
@@ -32,8 +77,48 @@ process_message* postboxPeek(process_postbox* pb, process_message* dest);
 process_message* postboxTop(process_postbox* pb, process_message* dest);
 
 /**
- * Pushes the given message to the postbox
+ * Pops up to max messages from the postbox into dest, oldest first. Returns the number of messages copied
+ */
+unsigned int postboxTopBatch(process_postbox* pb, process_message* dest, unsigned int max);
+
+/**
+ * Pushes the given message to the postbox, never sleeping. Returns 1 if it was queued or 0 if the postbox was full
+ * and it was dropped
+ */
+unsigned char postboxPush(process_postbox* pb, process_message* msg);
+
+/**
+ * postboxPush which sleeps untill there is room if the policy of the postbox is POSTBOX_BLOCK_SENDER. Can't be used
+ * from interrupt handlers
+ */
+unsigned char postboxPushWait(process_postbox* pb, process_message* msg);
+
+/**
+ * Set the limit (0 for the default) and policy of the postbox
+ */
+void postboxSetLimit(process_postbox* pb, unsigned int limit, unsigned char policy);
+
+/**
+ * Fill in the postbox counters of info
+ */
+void postboxFillInfo(process_postbox* pb, process_info_t* info);
+
+/**
+ * Add / remove a poll watch on the postbox, it reports POLL_READABLE for every message pushed. A new watch is
+ * signalled straight away if there are messages waiting
+ */
+void postboxWatch(process_postbox* pb, poll_watch_t* watch);
+void postboxUnwatch(process_postbox* pb, poll_watch_t* watch);
+
+/**
+ * Block untill the postbox has a message waiting or the given number of clock ticks pass (0 waits forever).
+ * Returns 1 if there is a message waiting
+ */
+unsigned char postboxWaitForMessage(process_postbox* pb, unsigned long ticks);
+
+/**
+ * Throw away any messages left in the postbox (freeing the pages granted with them) and free its slots
  */
-void postboxPush(process_postbox* pb, process_message* msg);
+void postboxFree(process_postbox* pb);
 
 #endif //_PROCESS_POSTBOX_DEF_H
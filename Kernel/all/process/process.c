@@ -6,6 +6,7 @@
  */
 
 #include <process/process.h>
+#include <scheduler/scheduler.h>
 
 void renameCurrentProcess(const char* str) {
 	setProcessName(getCurrentProcess(), str);
@@ -16,5 +17,5 @@ void setProcessName(process_t* proc, const char* Name) {
 }
 
 void setProcessExecutionDirectory(process_t* proc, fs_node_t* node) {
-	proc->executionDirectory = node;
+	processLeader(proc)->executionDirectory = node;
 }
@@ -0,0 +1,62 @@
+#include <process/process_queue.h>
+#include <process/process.h>
+
+unsigned char processQueueEmpty(process_queue_t* queue) {
+	return queue->first == 0;
+}
+
+void processQueuePush(process_queue_t* queue, process_t* process) {
+	process->queueNext = 0;
+
+	if (queue->last) {
+		queue->last->queueNext = process;
+	} else {
+		queue->first = process;
+	}
+
+	queue->last = process;
+}
+
+process_t* processQueuePop(process_queue_t* queue) {
+	process_t* process = queue->first;
+
+	if (!process) {
+		return 0;
+	}
+
+	queue->first = process->queueNext;
+
+	if (!queue->first) {
+		queue->last = 0;
+	}
+
+	process->queueNext = 0;
+	return process;
+}
+
+unsigned char processQueueRemove(process_queue_t* queue, process_t* process) {
+	process_t* prev = 0;
+
+	for (process_t* iter = queue->first; iter; iter = iter->queueNext) {
+		if (iter == process) {
+
+			//Unlink it, fixing up the head or tail if needed
+			if (prev) {
+				prev->queueNext = iter->queueNext;
+			} else {
+				queue->first = iter->queueNext;
+			}
+
+			if (queue->last == iter) {
+				queue->last = prev;
+			}
+
+			iter->queueNext = 0;
+			return 1;
+		}
+
+		prev = iter;
+	}
+
+	return 0;
+}
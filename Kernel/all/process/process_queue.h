@@ -0,0 +1,36 @@
+#ifndef _PROCESS_QUEUE_DEF_H_
+#define _PROCESS_QUEUE_DEF_H_
+
+struct processStructure;
+
+/**
+ * A FIFO queue of processes. The link is stored inside the process structure (queueNext)
+ * so a process can only be on one queue at a time, but nothing needs to be allocated to
+ * add or remove a process which makes the queue safe to use from interrupt handlers
+ */
+typedef struct {
+	struct processStructure* first;
+	struct processStructure* last;
+} process_queue_t;
+
+/**
+ * Returns 1 if the queue is empty, 0 otherwise
+ */
+unsigned char processQueueEmpty(process_queue_t* queue);
+
+/**
+ * Add the process to the end of the queue
+ */
+void processQueuePush(process_queue_t* queue, struct processStructure* process);
+
+/**
+ * Remove the process at the front of the queue and return it, returns 0 if the queue is empty
+ */
+struct processStructure* processQueuePop(process_queue_t* queue);
+
+/**
+ * Remove the given process from anywhere in the queue, returns 1 if it was found
+ */
+unsigned char processQueueRemove(process_queue_t* queue, struct processStructure* process);
+
+#endif //_PROCESS_QUEUE_DEF_H_
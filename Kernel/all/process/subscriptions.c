@@ -0,0 +1,89 @@
+#include <process/subscriptions.h>
+#include <process/postbox.h>
+#include <lock/spinlock.h>
+#include <stdlib.h>
+
+typedef struct subscription {
+	process_t* process;
+	struct subscription* next;
+} subscription_t;
+
+static subscription_t* subscribers[POSTBOX_EVENT_BITS];
+
+//Taken with interrupts disabled as input is broadcast from interrupt handlers. Broadcasts push under it, which can
+//grow a postbox (malloc and free) or drop the oldest message and its grant (free and freeUnownedFrame). The heap and
+//the free frame stack are both taken with interrupts disabled so that is safe here, and growing only happens when a
+//ring is full (it doubles each time)
+static spinlock_t subscriptionLock = SPINLOCK_INIT("subscriptions");
+
+void subscriptionsSetFlags(process_t* process, uint32_t flags) {
+
+	//A node for every bit that might be added, whatever isn't used is freed once the lock is dropped
+	subscription_t* spare = 0;
+
+	for (unsigned int i = 0; i < POSTBOX_EVENT_BITS; i++) {
+		if (flags & (1 << i)) {
+			subscription_t* node = malloc(sizeof(subscription_t));
+			node->next = spare;
+			spare = node;
+		}
+	}
+
+	irq_flags_t irq = spinlockAcquireIrqSave(&subscriptionLock);
+
+	uint32_t old = process->postboxFlags;
+
+	for (unsigned int i = 0; i < POSTBOX_EVENT_BITS; i++) {
+		uint32_t bit = 1 << i;
+
+		if ((flags & bit) && !(old & bit)) {
+			subscription_t* node = spare;
+			spare = node->next;
+
+			node->process = process;
+			node->next = subscribers[i];
+			subscribers[i] = node;
+		} else if (!(flags & bit) && (old & bit)) {
+
+			//Unlink it and keep it with the spares to be freed
+			for (subscription_t** link = &subscribers[i]; *link; link = &(*link)->next) {
+				if ((*link)->process == process) {
+					subscription_t* node = *link;
+					*link = node->next;
+
+					node->next = spare;
+					spare = node;
+					break;
+				}
+			}
+		}
+	}
+
+	process->postboxFlags = flags;
+
+	spinlockReleaseIrqRestore(&subscriptionLock, irq);
+
+	while (spare) {
+		subscription_t* next = spare->next;
+		free(spare);
+		spare = next;
+	}
+}
+
+void subscriptionsBroadcast(process_message* msg, uint32_t bit) {
+
+	//Exactly one bit, a mask would only ever have reached the subscribers of its lowest bit
+	if (!bit || (bit & (bit - 1))) {
+		return;
+	}
+
+	unsigned int index = __builtin_ctz(bit);
+
+	irq_flags_t irq = spinlockAcquireIrqSave(&subscriptionLock);
+
+	for (subscription_t* iter = subscribers[index]; iter; iter = iter->next) {
+		postboxPush(&iter->process->processPostbox, msg);
+	}
+
+	spinlockReleaseIrqRestore(&subscriptionLock, irq);
+}
@@ -0,0 +1,24 @@
+#ifndef _PROCESS_SUBSCRIPTIONS_DEF_H_
+#define _PROCESS_SUBSCRIPTIONS_DEF_H_
+#include <process/process.h>
+#include <process/message.h>
+
+/**
+ * The number of event bits a process can subscribe to with its postbox flags
+ */
+#define POSTBOX_EVENT_BITS 32
+
+/**
+ * Every event bit has a list of the processes whose postbox flags have it set, so a broadcast only touches the
+ * processes that want to hear about it. Set the postbox flags of the process given, moving it between the lists.
+ * The process has to be the leader of its process
+ */
+void subscriptionsSetFlags(process_t* process, uint32_t flags);
+
+/**
+ * Push the message to the postbox of every process subscribed to the event bit given, nothing is sent unless
+ * exactly one bit is set. Safe to call from interrupt handlers
+ */
+void subscriptionsBroadcast(process_message* msg, uint32_t bit);
+
+#endif //_PROCESS_SUBSCRIPTIONS_DEF_H_
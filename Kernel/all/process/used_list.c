@@ -1,6 +1,8 @@
 #include <process/process.h>
 #include <stdlib.h>
 #include <debug/debug.h>
+#include <mm/physical.h>
+#include <lock/spinlock.h>
 
 const unsigned long usedListExpansionSize = 1024;
 
@@ -10,6 +12,9 @@ void initializeUsedList(process_t* process) {
 	process->usedListNumItems = 0;
 }
 
+/**
+ * Make room for another usedListExpansionSize frames, the usedListLock of the process must be held
+ */
 void expandUsedList(process_t* process) {
 	void** newAllocation = malloc((process->usedListMaxItems + usedListExpansionSize) * sizeof(void*));
 	memcpy(newAllocation, process->usedListRoot, process->usedListNumItems * sizeof(void*));
@@ -27,6 +32,7 @@ char usedListHasItems(process_t* process) {
 }
 
 void usedListAdd(process_t* process, void* location) {
+	spinlockAcquire(&process->usedListLock);
 
 	if (process->usedListNumItems == process->usedListMaxItems) {
 		expandUsedList(process);
@@ -38,31 +44,37 @@ void usedListAdd(process_t* process, void* location) {
 	ulocation--;
 
 	process->usedListNumItems++;
+	spinlockRelease(&process->usedListLock);
 }
 
 void usedListRemove(process_t* process, void* location) {
-
-	void** ulocation = process->usedListRoot;
-	unsigned long iter = 0;
+	spinlockAcquire(&process->usedListLock);
 
 	for (unsigned int i = 0; i < process->usedListNumItems; i++) {
 		if (process->usedListRoot[i] == location) {
 			memcpy(&process->usedListRoot[i], &process->usedListRoot[i + 1], (process->usedListNumItems - i) * sizeof(void*));
 			process->usedListNumItems--;
-			return;
+			break;
 		}
 	}
+
+	spinlockRelease(&process->usedListLock);
 }
 
 void usedListFree(process_t* process) {
+	spinlockAcquire(&process->usedListLock);
 
-	while (usedListHasItems(process)) {
-		void* top = usedListTop(process);
-		freeFrame(top);
-		usedListRemove(process, top);
+	//freeFrame would look for each frame on the used list of whoever is freeing the process instead
+	for (unsigned long i = 0; i < process->usedListNumItems; i++) {
+		freeUnownedFrame((MEM_LOC) process->usedListRoot[i]);
 	}
 
+	process->usedListNumItems = 0;
+
 	if (process->usedListRoot != 0) {
 		free(process->usedListRoot);
+		process->usedListRoot = 0;
 	}
+
+	spinlockRelease(&process->usedListLock);
 }
\ No newline at end of file
@@ -2,117 +2,589 @@
 #include <panic/panic.h>
 #include <stdlib.h>
 #include <common.h>
-#include <stack/kstack.h>
 #include <debug/debug.h>
+#include <interrupts/interrupts.h>
+#include <cpu/percpu.h>
+#include <lock/spinlock.h>
+#include <clock/clock.h>
+#include <syscall/ring.h>
+#include <system/kernel_data_page.h>
+#include <process/accounting.h>
+#include <syscall/ipc.h>
 
 struct process_entry_t {
 	process_t* process_pointer;
 	int ticks_tell_die;
+
+	//The next entry on the run queue of the CPU the process is on
 	struct process_entry_t* next;
+
+	//The next entry in the list of every process, used to find processes by PID or index
+	struct process_entry_t* allNext;
+
+	//The CPU whose run queue the entry is on
+	cpu_t* cpu;
 };
 
 typedef struct process_entry_t scheduler_proc;
 
+/**
+ * Every process known to the scheduler in the order they were added, the kernel process is always first.
+ * Idle processes are not included
+ */
 scheduler_proc* list_root = 0;
-scheduler_proc* list_current = 0;
 
-void swapToProcess(scheduler_proc* scheduler_entry) {
+/**
+ * The number of entries on list_root, also published on the kernel data page
+ */
+static unsigned int processCount = 0;
+
+static void setProcessCount(unsigned int count) {
+	processCount = count;
+
+	if (kernelDataPage()) {
+		kernelDataPage()->numProcesses = count;
+	}
+}
+
+/**
+ * processListLock protects list_root and the allNext links. schedulerLock protects the run queues, what each CPU
+ * is running, the blocked flags and every process queue the scheduler manages (wait queues, the zombie queue).
+ * When both are needed processListLock is taken first, and any other lock (a postbox lock for example) is
+ * taken before schedulerLock.
+ *
+ * schedulerLock is held across a context switch: the process switching away takes it and whatever process
+ * runs next on that CPU releases it, either on the way out of schedulerYieldLocked or through
+ * schedulerSwitchFinished if it is running for the first time
+ *
+ * Every CPU shares the one schedulerLock rather than having a lock per run queue. Blocking and waking rely on the
+ * waker and the process going to sleep agreeing on a single lock for the blocked flag and the queue it sleeps on, and
+ * a process moves between CPUs whenever it is stolen, handed off to or woken, so per-CPU locks would also need a lock
+ * per process and a lock-and-retry loop to find which run queue it is on. Stealing and handoffs would take two run
+ * queue locks in the middle of a switch, with the incoming process releasing both. The lock is only held for a queue
+ * operation or a switch, the tick of a busy CPU only takes it once the time slice ends, waking sleepers checks the
+ * sleep queue before taking it, and there are at most MAX_CPUS CPUs. If it ever does need splitting, run queue locks
+ * are taken in order of CPU id
+ */
+static spinlock_t processListLock = SPINLOCK_INIT("process list");
+static spinlock_t schedulerLock = SPINLOCK_INIT("scheduler");
+
+/**
+ * Set the entry the CPU is running, schedulerLock must be held (or the CPU not yet be active)
+ */
+static void setCurrent(cpu_t* cpu, scheduler_proc* entry) {
+	cpu->current = entry;
+	cpu->currentProcess = entry->process_pointer;
+}
+
+static void swapToProcess(cpu_t* cpu, scheduler_proc* scheduler_entry) {
 
-	process_t* old_proc = list_current->process_pointer;
-	setKernelStack(KERNEL_STACK_START);
+	process_t* old_proc = cpu->current->process_pointer;
 
 	//Swap to the next process
-	list_current = scheduler_entry;
-	process_t* new_proc = list_current->process_pointer;
-	list_current->ticks_tell_die = _STD_NANO_;
+	setCurrent(cpu, scheduler_entry);
+	process_t* new_proc = scheduler_entry->process_pointer;
+	scheduler_entry->ticks_tell_die = _STD_NANO_;
 	switchProcess(old_proc, new_proc);
 }
 
-void schedulerYield() {
-	ASSERT(list_current && list_root,
+/**
+ * Processes that have exited but not yet been freed, and the queue the reaper sleeps on while there are none
+ */
+static process_queue_t zombieQueue;
+static process_queue_t reaperQueue;
+
+/**
+ * Processes sleeping for a number of ticks (or blocked with a timeout), in the order they wake up in. Linked through
+ * sleepNext so a process can be on a wait queue at the same time
+ */
+static process_t* sleepQueue = 0;
+
+static unsigned char processRunnable(process_t* process) {
+	return !process->blocked && !process->shouldDestroy;
+}
+
+/**
+ * Add the entry to the end of the CPUs run queue
+ */
+static void runQueueInsert(cpu_t* cpu, scheduler_proc* entry) {
+	entry->cpu = cpu;
+
+	if (!cpu->runQueue) {
+		entry->next = entry;
+		cpu->runQueue = entry;
+	} else {
+		scheduler_proc* last = cpu->runQueue;
+
+		while (last->next != cpu->runQueue) {
+			last = last->next;
+		}
+
+		last->next = entry;
+		entry->next = cpu->runQueue;
+	}
+
+	cpu->runQueueLength++;
+}
+
+/**
+ * Take the entry off the run queue of the CPU it is on. The entry must not be running
+ */
+static void runQueueUnlink(scheduler_proc* entry) {
+	cpu_t* cpu = entry->cpu;
+
+	if (entry->next == entry) {
+		cpu->runQueue = 0;
+	} else {
+		scheduler_proc* prev = entry;
+
+		while (prev->next != entry) {
+			prev = prev->next;
+		}
+
+		prev->next = entry->next;
+
+		if (cpu->runQueue == entry) {
+			cpu->runQueue = entry->next;
+		}
+	}
+
+	entry->next = 0;
+	entry->cpu = 0;
+	cpu->runQueueLength--;
+}
+
+/**
+ * Find the next process on the CPUs run queue that can run, starting after the current process and
+ * ending with it (or covering the whole queue if the CPU is idle)
+ */
+static scheduler_proc* schedulerFindRunnable(cpu_t* cpu) {
+
+	if (!cpu->runQueue) {
+		return 0;
+	}
+
+	scheduler_proc* start = cpu->current == cpu->idle ? cpu->runQueue : cpu->current->next;
+	scheduler_proc* iter = start;
+
+	do {
+		if (processRunnable(iter->process_pointer)) {
+			return iter;
+		}
+
+		iter = iter->next;
+	} while (iter != start);
+
+	return 0;
+}
+
+/**
+ * Called when the CPU has nothing to run. Takes a runnable process that is not currently executing from
+ * the CPU with the longest run queue and moves it to this CPU
+ */
+static scheduler_proc* schedulerSteal(cpu_t* thief) {
+	cpu_t* victim = 0;
+
+	for (unsigned int i = 0; i < cpuCount(); i++) {
+		cpu_t* cpu = cpuGet(i);
+
+		if (cpu != thief && cpu->schedulerActive && cpu->runQueue
+				&& (!victim || cpu->runQueueLength > victim->runQueueLength)) {
+			victim = cpu;
+		}
+	}
+
+	if (!victim) {
+		return 0;
+	}
+
+	scheduler_proc* iter = victim->runQueue;
+
+	do {
+		if (iter != victim->current && processRunnable(iter->process_pointer)) {
+			runQueueUnlink(iter);
+			runQueueInsert(thief, iter);
+			return iter;
+		}
+
+		iter = iter->next;
+	} while (iter != victim->runQueue);
+
+	return 0;
+}
+
+/**
+ * Returns the active CPU with the shortest run queue
+ */
+static cpu_t* schedulerLeastLoadedCpu() {
+	cpu_t* best = 0;
+
+	for (unsigned int i = 0; i < cpuCount(); i++) {
+		cpu_t* cpu = cpuGet(i);
+
+		if (cpu->schedulerActive && (!best || cpu->runQueueLength < best->runQueueLength)) {
+			best = cpu;
+		}
+	}
+
+	return best;
+}
+
+/**
+ * Switch to the next process that can run on this CPU. schedulerLock must be held and is still held when the
+ * current process is next switched back to
+ */
+static void schedulerYieldLocked() {
+	cpu_t* cpu = getCpu();
+
+	ASSERT(cpu->current && list_root,
 			"Cannot yield if scheduler has not been initialized");
-	if (list_current->next->process_pointer->shouldDestroy == 1) {
-		swapToProcess(list_root);
+
+	cpu->needResched = 0;
+
+	scheduler_proc* next = schedulerFindRunnable(cpu);
+
+	if (!next && cpu->schedulerActive) {
+		next = schedulerSteal(cpu);
+	}
+
+	//Nothing can run, the idle process halts untill an interrupt wakes something up
+	if (!next) {
+		next = cpu->idle;
+	}
+
+	if (next == cpu->current) {
+		cpu->current->ticks_tell_die = _STD_NANO_;
 	} else {
-		swapToProcess(list_current->next);
+		swapToProcess(cpu, next);
 	}
 }
 
-void schedulerOnTick() {
+/**
+ * Switch straight to the entry given instead of picking the next process, giving it what is left of the current time
+ * slice. The entry is moved to this CPU if it is on another one, if it can't run here right now the next process is
+ * picked as usual. schedulerLock must be held and is still held when the current process is next switched back to
+ */
+static void schedulerHandoffLocked(scheduler_proc* target) {
+	cpu_t* cpu = getCpu();
 
-	if (list_root == 0) {
+	if (!cpu->schedulerActive || !processRunnable(target->process_pointer) || target->cpu->current == target) {
+		schedulerYieldLocked();
 		return;
 	}
 
-	if (!list_current->ticks_tell_die) {
+	if (target->cpu != cpu) {
+		runQueueUnlink(target);
+		runQueueInsert(cpu, target);
+	}
+
+	cpu->needResched = 0;
+
+	process_t* old_proc = cpu->current->process_pointer;
+	int remaining = cpu->current->ticks_tell_die;
+
+	setCurrent(cpu, target);
+	target->ticks_tell_die = remaining ? remaining : 1;
+	switchProcess(old_proc, target->process_pointer);
+}
+
+void schedulerYield() {
+	irq_flags_t flags = spinlockAcquireIrqSave(&schedulerLock);
+	schedulerYieldLocked();
+	spinlockReleaseIrqRestore(&schedulerLock, flags);
+}
+
+void schedulerSwitchFinished() {
+	spinlockRelease(&schedulerLock);
+	enableInterrupts();
+}
+
+void schedulerIdleLoop() {
+
+	for (;;) {
+		enableInterrupts();
+		haltTillNextInterrupt();
 		schedulerYield();
+	}
+}
+
+void schedulerIdleEntry() {
+	schedulerSwitchFinished();
+	schedulerIdleLoop();
+}
+
+void schedulerOnTick() {
+	cpu_t* cpu = getCpu();
+
+	//The idle loop yields on every interrupt by itself
+	if (list_root == 0 || !cpu->current || cpu->current == cpu->idle) {
+		return;
+	}
+
+	//A process polling its syscall ring gets it serviced on its own ticks
+	syscallRingPoll();
+
+	if (cpu->current->ticks_tell_die) {
+		cpu->current->process_pointer->processingTime++;
+		cpu->current->ticks_tell_die--;
+	} else if (cpu->preemptCount) {
+		//A process holding a spinlock can't be switched away from, it goes at its next preemption point or tick instead
+		cpu->needResched = 1;
 	} else {
-		list_current->process_pointer->processingTime++;
-		list_current->ticks_tell_die--;
+		schedulerYield();
 	}
 }
 
-//To anybody calling this function, remember to re-enable interrupts where applicable
+void schedulerPreemptionPoint() {
+	if (PERCPU_READ(needResched) && !PERCPU_READ(preemptCount)) {
+		schedulerYield();
+	}
+}
+
+/**
+ * Put the process on the sleep queue to be woken after the given number of ticks, schedulerLock must be held
+ */
+static void sleepQueueInsert(process_t* process, unsigned long ticks) {
+	process->wakeTick = getClockTicks() + ticks;
+	process->sleeping = 1;
+
+	//Keep the queue in wake order so the tick only ever has to look at the front of it
+	process_t** link = &sleepQueue;
+
+	while (*link && (*link)->wakeTick <= process->wakeTick) {
+		link = &(*link)->sleepNext;
+	}
+
+	process->sleepNext = *link;
+	*link = process;
+}
+
+static void sleepQueueRemove(process_t* process) {
+
+	for (process_t** link = &sleepQueue; *link; link = &(*link)->sleepNext) {
+		if (*link == process) {
+			*link = process->sleepNext;
+			break;
+		}
+	}
+
+	process->sleepNext = 0;
+	process->sleeping = 0;
+}
+
+/**
+ * Put the current process on the queue and switch away from it, schedulerLock must be held
+ */
+static void schedulerBlockLocked(process_queue_t* queue) {
+	process_t* current = getCurrentProcess();
+	current->blocked = 1;
+	current->waitQueue = queue;
+	processQueuePush(queue, current);
+	schedulerYieldLocked();
+}
+
+unsigned char schedulerBlockTimeout(process_queue_t* queue, spinlock_t* lock, unsigned long ticks) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&schedulerLock);
+
+	//Wakers need schedulerLock to take this process off the queue, so the callers lock can go now without missing one
+	spinlockRelease(lock);
+
+	process_t* current = getCurrentProcess();
+	current->timedOut = 0;
+
+	if (ticks) {
+		sleepQueueInsert(current, ticks);
+	}
+
+	schedulerBlockLocked(queue);
+	unsigned char woken = !current->timedOut;
+
+	spinlockReleaseIrqRestore(&schedulerLock, flags);
+	spinlockAcquire(lock);
+	return woken;
+}
+
+void schedulerBlock(process_queue_t* queue, spinlock_t* lock) {
+	schedulerBlockTimeout(queue, lock, 0);
+}
+
+/**
+ * Make a blocked or sleeping process runnable again, it must already be off its wait queue
+ */
+static void schedulerWakeProcessLocked(process_t* process) {
+
+	if (process->sleeping) {
+		sleepQueueRemove(process);
+	}
+
+	process->waitQueue = 0;
+	process->blocked = 0;
+}
+
+static unsigned char schedulerWakeOneLocked(process_queue_t* queue) {
+	process_t* process = processQueuePop(queue);
+
+	if (!process) {
+		return 0;
+	}
+
+	schedulerWakeProcessLocked(process);
+	return 1;
+}
+
+static void schedulerWakeAllLocked(process_queue_t* queue) {
+	while (schedulerWakeOneLocked(queue)) {}
+}
+
+void schedulerBlockHandoff(process_queue_t* queue, spinlock_t* lock, process_t* target) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&schedulerLock);
+	spinlockRelease(lock);
+
+	if (target->waitQueue) {
+		processQueueRemove(target->waitQueue, target);
+	}
+
+	schedulerWakeProcessLocked(target);
+
+	process_t* current = getCurrentProcess();
+	current->timedOut = 0;
+	current->blocked = 1;
+	current->waitQueue = queue;
+	processQueuePush(queue, current);
+
+	schedulerHandoffLocked(target->schedulerEntry);
+
+	spinlockReleaseIrqRestore(&schedulerLock, flags);
+	spinlockAcquire(lock);
+}
+
+void schedulerSleep(unsigned long ticks) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&schedulerLock);
+
+	process_t* current = getCurrentProcess();
+	sleepQueueInsert(current, ticks);
+	current->blocked = 1;
+	schedulerYieldLocked();
+
+	spinlockReleaseIrqRestore(&schedulerLock, flags);
+}
+
+/**
+ * Called every clock tick to wake the sleeping processes that are due
+ */
+static void schedulerWakeSleepers() {
+
+	if (!sleepQueue) {
+		return;
+	}
+
+	irq_flags_t flags = spinlockAcquireIrqSave(&schedulerLock);
+
+	while (sleepQueue && sleepQueue->wakeTick <= getClockTicks()) {
+		process_t* process = sleepQueue;
+
+		//A timed block ran out, take it off whatever it was waiting on
+		if (process->waitQueue) {
+			processQueueRemove(process->waitQueue, process);
+			process->timedOut = 1;
+		}
+
+		schedulerWakeProcessLocked(process);
+	}
+
+	spinlockReleaseIrqRestore(&schedulerLock, flags);
+}
+
+unsigned char schedulerWakeOne(process_queue_t* queue) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&schedulerLock);
+	unsigned char woken = schedulerWakeOneLocked(queue);
+	spinlockReleaseIrqRestore(&schedulerLock, flags);
+	return woken;
+}
+
+void schedulerWakeAll(process_queue_t* queue) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&schedulerLock);
+	schedulerWakeAllLocked(queue);
+	spinlockReleaseIrqRestore(&schedulerLock, flags);
+}
+
 void schedulerAdd(process_t* op) {
 
 	//Create and set new_process to all 0's
 	scheduler_proc* new_process = malloc(sizeof(scheduler_proc));
 	memset(new_process, 0, sizeof(scheduler_proc));
 	new_process->process_pointer = op;
-	unsigned int iterator = 0;
+	op->schedulerEntry = new_process;
+	accountingStart(op);
+
+	irq_flags_t flags = spinlockAcquireIrqSave(&processListLock);
 	scheduler_proc* iterator_process = list_root;
 
 	//Loop to find the last entry in the list
-	for (;;) {
-		if (iterator_process->next == list_root) {
-			break;
-		} else {
-			iterator_process = iterator_process->next;
-		}
+	while (iterator_process->allNext) {
+		iterator_process = iterator_process->allNext;
 	}
-	iterator_process->next = new_process;
-	new_process->next = list_root;
+
+	iterator_process->allNext = new_process;
+	setProcessCount(processCount + 1);
+
+	//Place it on whichever CPU has the least to do
+	spinlockAcquire(&schedulerLock);
+	runQueueInsert(schedulerLeastLoadedCpu(), new_process);
+	spinlockRelease(&schedulerLock);
+
+	spinlockReleaseIrqRestore(&processListLock, flags);
 }
 
-//To anybody calling this, remember to re-enable interrupts
-void schedulerRemove(process_t* op) {
+/**
+ * Take the process off the process list and its run queue, returns the entry or 0 if the process wasn't found.
+ * Both locks must be held
+ */
+static scheduler_proc* schedulerUnlinkLocked(process_t* op) {
 
 	//Find the scheduler entry
 	scheduler_proc* iterator_process = list_root;
 
 	for (;;) {
-		if (iterator_process->next == list_root) {
-			return; //Cannot find the right proc
+		if (!iterator_process->allNext) {
+			return 0; //Cannot find the right proc
 		} else {
 			//Is the next process the one that needs to be removed
-			if (iterator_process->next->process_pointer == op) {
+			if (iterator_process->allNext->process_pointer == op) {
 				//Process
 				break;
 			} else {
-				iterator_process = iterator_process->next;
+				iterator_process = iterator_process->allNext;
 			}
 		}
 	}
 
 	//Store the procecess
-	scheduler_proc* next = iterator_process->next;
-	if (list_current == next) {
+	scheduler_proc* next = iterator_process->allNext;
+	if (next->cpu->current == next) {
 		PANIC(
 				"Scheduler trying to remove currently accessed process, this shouldn't happen... DEBUG!!\n");
 	}
 
-	//Remove it from the list
-	iterator_process->next = iterator_process->next->next;
-	free(next);
+	//Remove it from the lists
+	iterator_process->allNext = next->allNext;
+	runQueueUnlink(next);
+	setProcessCount(processCount - 1);
+	return next;
 }
 
-process_t* getCurrentProcess() {
+void schedulerRemove(process_t* op) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&processListLock);
+	spinlockAcquire(&schedulerLock);
 
-	if (!list_current) {
-		return 0;
-	}
+	scheduler_proc* entry = schedulerUnlinkLocked(op);
 
-	return list_current->process_pointer;
+	spinlockRelease(&schedulerLock);
+	spinlockReleaseIrqRestore(&processListLock, flags);
+
+	if (entry) {
+		free(entry);
+	}
 }
 
 int schedulerNumProcesses() {
@@ -120,82 +592,194 @@ int schedulerNumProcesses() {
 	ASSERT(list_root,
 			"schedulerNumProcess cannot be run before the scheduler is initialized");
 
-	scheduler_proc* iter = list_root;
-	int numTotal = 0;
-	while (1) {
-		numTotal++;
-
-		if (iter->next == list_root) {
-			break;
-		}
-
-		iter = iter->next;
-	}
-	return numTotal;
+	return processCount;
 }
 
 void schedulerKillCurrentProcess() {
-	ASSERT(list_current, "Cannot kill current - no executing process");
+	ASSERT(getCurrentProcess(), "Cannot kill current - no executing process");
+
+	//Anybody in the middle of a call to the process would never get a reply
+	ipcProcessExit(getCurrentProcess());
+
+	//Whoever is at the other end of its pipes finds out now rather than once it is freed
+	handlesProcessExit(getCurrentProcess());
+
+	spinlockAcquireIrqSave(&schedulerLock);
+
 	process_t* process = getCurrentProcess();
 	process->shouldDestroy = 1;
-	schedulerYield();
+
+	//Hand the process to the reaper and let anybody waiting on it collect the return value
+	processQueuePush(&zombieQueue, process);
+	schedulerWakeAllLocked(&process->exitWaiters);
+	schedulerWakeAllLocked(&reaperQueue);
+
+	schedulerYieldLocked();
 	for (;;) {}
 }
 
+static process_t* schedulerFindPidLocked(unsigned int pid) {
+
+	for (scheduler_proc* iterator = list_root; iterator; iterator = iterator->allNext) {
+		//If it is the process I'm loooking for return it
+		if (iterator->process_pointer->id == pid) {
+			return iterator->process_pointer;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * A zombie can be freed once nobody is waiting on it and either its return value has been
+ * collected or there is no parent left that could collect it
+ */
+static unsigned char zombieReapable(process_t* zombie) {
+
+	if (zombie->exitWaiterCount) {
+		return 0;
+	}
+
+	if (zombie->exitCollected || zombie->parentId == 0) {
+		return 1;
+	}
+
+	process_t* parent = schedulerFindPidLocked(zombie->parentId);
+	return !parent || parent->shouldDestroy;
+}
+
+process_t* schedulerWaitForZombie() {
+	irq_flags_t flags = spinlockAcquireIrqSave(&processListLock);
+	spinlockAcquire(&schedulerLock);
+
+	for (;;) {
+		for (process_t* iter = zombieQueue.first; iter; iter = iter->queueNext) {
+			if (zombieReapable(iter)) {
+				processQueueRemove(&zombieQueue, iter);
+
+				//Nobody can find it by PID once it is off the process list, so it is safe to free
+				scheduler_proc* entry = schedulerUnlinkLocked(iter);
+
+				spinlockRelease(&schedulerLock);
+				spinlockReleaseIrqRestore(&processListLock, flags);
+
+				free(entry);
+				return iter;
+			}
+		}
+
+		//Both locks were held while checking, so no zombie can be missed between here and sleeping
+		spinlockRelease(&processListLock);
+		schedulerBlockLocked(&reaperQueue);
+		spinlockRelease(&schedulerLock);
+
+		spinlockAcquire(&processListLock);
+		spinlockAcquire(&schedulerLock);
+	}
+}
+
+int schedulerWaitForExit(unsigned int pid) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&processListLock);
+
+	process_t* process = schedulerFindPidLocked(pid);
+
+	if (!process || process == getCurrentProcess()) {
+		spinlockReleaseIrqRestore(&processListLock, flags);
+		return -1;
+	}
+
+	//Once the waiter count is up the reaper will leave the process alone, so the list lock can go
+	spinlockAcquire(&schedulerLock);
+	process->exitWaiterCount++;
+	spinlockRelease(&processListLock);
+
+	while (!process->shouldDestroy) {
+		schedulerBlockLocked(&process->exitWaiters);
+	}
+
+	int returnValue = process->returnValue;
+	process->exitCollected = 1;
+	process->exitWaiterCount--;
+
+	//Last one out lets the reaper free the process
+	if (!process->exitWaiterCount) {
+		schedulerWakeAllLocked(&reaperQueue);
+	}
+
+	spinlockReleaseIrqRestore(&schedulerLock, flags);
+	return returnValue;
+}
+
 process_t* schedulerReturnProcess(unsigned int iter) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&processListLock);
 	scheduler_proc* iterator = list_root;
 
-	for (unsigned int i = 0; i < iter; i++) {
-		if (iterator->next == list_root) {
-			return 0;
-		}
-		iterator = iterator->next;
+	for (unsigned int i = 0; i < iter && iterator; i++) {
+		iterator = iterator->allNext;
 	}
 
-	return iterator->process_pointer;
+	process_t* process = iterator ? iterator->process_pointer : 0;
+	spinlockReleaseIrqRestore(&processListLock, flags);
+
+	return process;
 }
 
 process_t* schedulerGetProcessFromPid(unsigned int pid) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&processListLock);
+	process_t* process = schedulerFindPidLocked(pid);
+	spinlockReleaseIrqRestore(&processListLock, flags);
+	return process;
+}
 
+process_t* schedulerPinProcess(unsigned int iter) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&processListLock);
 	scheduler_proc* iterator = list_root;
-	unsigned int i = 0;
 
-	for (;;) {
-		//If it is the process I'm loooking for break
-		if (iterator->process_pointer->id == pid)
-			break;
+	for (unsigned int i = 0; i < iter && iterator; i++) {
+		iterator = iterator->allNext;
+	}
 
-		//If its the last entry and not correct then return null
-		if (iterator->next == list_root)
-			return 0;
+	process_t* process = iterator ? iterator->process_pointer : 0;
 
-		//Set the iterator to the next entry
-		iterator = iterator->next;
+	//The reaper only frees a process after taking it off the list under the same lock
+	if (process) {
+		processPin(process);
 	}
 
-	//Return what I got
-	return iterator->process_pointer;
+	spinlockReleaseIrqRestore(&processListLock, flags);
+	return process;
 }
 
-void schedulerGlobalMessage(process_message msg, unsigned int bit) {
-	scheduler_proc* iter = list_root;
+process_t* schedulerPinProcessFromPid(unsigned int pid) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&processListLock);
+	process_t* process = schedulerFindPidLocked(pid);
 
-	while (1) {
+	if (process) {
+		processPin(process);
+	}
 
-		//Test if this process wants to hear about this event
-		if (iter->process_pointer->postboxFlags & bit == bit) {
-			postboxPush(&iter->process_pointer->processPostbox, &msg);
-		}
+	spinlockReleaseIrqRestore(&processListLock, flags);
+	return process;
+}
 
-		if (iter->next == list_root)
-			break;
+void schedulerInitializeCpu(cpu_t* cpu, process_t* idle) {
+	scheduler_proc* idle_entry = malloc(sizeof(scheduler_proc));
+	memset(idle_entry, 0, sizeof(scheduler_proc));
+	idle_entry->process_pointer = idle;
+	idle_entry->cpu = cpu;
 
-		iter = iter->next;
-	}
+	cpu->idle = idle_entry;
+	setCurrent(cpu, idle_entry);
+}
 
+void schedulerActivateCpu(cpu_t* cpu) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&schedulerLock);
+	cpu->schedulerActive = 1;
+	spinlockReleaseIrqRestore(&schedulerLock, flags);
 }
 
 void schedulerInitialize(process_t* kp) {
+	cpu_t* cpu = getCpu();
 
 	//Create and set new_process to all 0's
 	scheduler_proc* new_process = malloc(sizeof(scheduler_proc));
@@ -203,13 +787,17 @@ void schedulerInitialize(process_t* kp) {
 
 	//Set its process pointer to the kernels processing path
 	new_process->process_pointer = kp;
+	kp->schedulerEntry = new_process;
 
-	//Loop backs
-	new_process->next = new_process;
+	//The boot processor is already running the kernel process, so it starts as the current entry instead of the idle one
+	schedulerInitializeCpu(cpu, initializeIdleProcess());
+	runQueueInsert(cpu, new_process);
+	setCurrent(cpu, new_process);
+	cpu->schedulerActive = 1;
 
-	//Set the root and current set of the list to new_process
 	list_root = new_process;
-	list_current = new_process;
+	setProcessCount(1);
 
 	registerClockTickCallback(schedulerOnTick);
+	registerClockTickCallback(schedulerWakeSleepers);
 }
@@ -1,21 +1,115 @@
 #ifndef _PROCESS_SCHEDULER_DEF_H_
 #define _PROCESS_SCHEDULER_DEF_H_
 #include <process/process.h>
+#include <cpu/percpu.h>
+#include <lock/spinlock.h>
 #define _STD_NANO_ 50
 
 void schedulerInitialize(process_t* kproc);
 
+/**
+ * Give the CPU an empty run queue with idle as the process it runs when nothing else can. The CPU starts
+ * out running idle, it only gets processes once schedulerActive is set on it
+ */
+void schedulerInitializeCpu(cpu_t* cpu, process_t* idle);
+
+/**
+ * Let the scheduler place processes on the CPU
+ */
+void schedulerActivateCpu(cpu_t* cpu);
+
+/**
+ * The body of every idle process, halts untill an interrupt and then looks for something to run
+ */
+void schedulerIdleLoop();
+
+/**
+ * Where an idle process starts when it is first switched to
+ */
+void schedulerIdleEntry();
+
+/**
+ * Must be called first thing by a process being run for the first time (a new process entry point, a fork child)
+ * to finish off the switch to it, releasing the scheduler lock and enabling interrupts
+ */
+void schedulerSwitchFinished();
+
 void schedulerAdd(process_t* new_process);
 void schedulerRemove(process_t* old_process);
 
-process_t* getCurrentProcess();
+/**
+ * Returns the process running on this CPU (0 before the scheduler is up). It is read in one instruction so the answer
+ * is right even if the process is moved to another CPU straight after
+ */
+static inline process_t* getCurrentProcess() {
+	return PERCPU_READ(currentProcess);
+}
+
 int schedulerNumProcesses();
 void schedulerKillCurrentProcess();
 void schedulerYield();
+
+/**
+ * Called on every clock tick of the CPU, switches away from the current process once its time slice is used up
+ */
+void schedulerOnTick();
+
+/**
+ * Somewhere a long running piece of kernel code holding no locks can be switched away from. Yields if the time
+ * slice of the process ran out while it couldn't be preempted
+ */
+void schedulerPreemptionPoint();
+
+/**
+ * Put the current process to sleep on the queue and switch away from it. lock must be held by the caller and
+ * protect whatever the caller is waiting for, anybody changing that and waking the queue must hold it too. The
+ * lock is dropped once the process is safely on the queue and held again when this returns, so the caller
+ * should re-check what it is waiting for in a loop
+ */
+void schedulerBlock(process_queue_t* queue, spinlock_t* lock);
+
+/**
+ * schedulerBlock which gives up after the given number of clock ticks (0 waits forever). Returns 1 if the process was
+ * woken, 0 if it timed out
+ */
+unsigned char schedulerBlockTimeout(process_queue_t* queue, spinlock_t* lock, unsigned long ticks);
+
+/**
+ * schedulerBlock that switches straight to target instead of picking the next process to run, waking it and giving it
+ * whatever is left of the current time slice. target has to be blocked, it is taken off whatever it was waiting on.
+ * Hands the CPU between the two ends of a synchronous call without a trip through the run queue
+ */
+void schedulerBlockHandoff(process_queue_t* queue, spinlock_t* lock, process_t* target);
+
+/**
+ * Put the current process to sleep for at least the given number of clock ticks
+ */
+void schedulerSleep(unsigned long ticks);
+
+/**
+ * Wake the first process sleeping on the queue (returning 0 if there was none) / every process sleeping on the queue
+ */
+unsigned char schedulerWakeOne(process_queue_t* queue);
+void schedulerWakeAll(process_queue_t* queue);
+
+/**
+ * Blocks untill an exited process can be freed, then removes it from the zombie queue and the scheduler and
+ * returns it. Only the System process should call this
+ */
+process_t* schedulerWaitForZombie();
+
+/**
+ * Blocks untill the process with the given PID exits and returns its return value (-1 if there is no such process)
+ */
+int schedulerWaitForExit(unsigned int pid);
 process_t* schedulerReturnProcess(unsigned int iter);
 process_t* schedulerGetProcessFromPid(unsigned int pid);
 
-//Send a message to all processes
-void schedulerGlobalMessage(process_message msg, unsigned int bit);
+/**
+ * schedulerReturnProcess / schedulerGetProcessFromPid which pin the process found, so it isn't freed untill the
+ * caller is done with it and calls processUnpin
+ */
+process_t* schedulerPinProcess(unsigned int iter);
+process_t* schedulerPinProcessFromPid(unsigned int pid);
 
 #endif //_PROCESS_SCHEDULER_DEF_H_
@@ -0,0 +1,133 @@
+#include <syscall/futex.h>
+#include <scheduler/scheduler.h>
+#include <mm/virt_mm.h>
+#include <mm/virtual.h>
+#include <lock/spinlock.h>
+#include <stdlib.h>
+
+#define FUTEX_BUCKETS 64
+
+/**
+ * The processes waiting on one futex. Created by the first waiter and freed by the last one to leave
+ */
+typedef struct futexQueue {
+	MEM_LOC key;
+	unsigned int waiters;
+	process_queue_t queue;
+	struct futexQueue* next;
+} futex_queue_t;
+
+/**
+ * The futexes whose keys hash to the bucket. The lock protects the list and orders a waiter checking the futex
+ * value against a waker, so a wake can't be missed between the check and sleeping
+ */
+typedef struct {
+	spinlock_t lock;
+	futex_queue_t* queues;
+} futex_bucket_t;
+
+static futex_bucket_t futexBuckets[FUTEX_BUCKETS];
+
+void initializeFutexes() {
+
+	for (unsigned int i = 0; i < FUTEX_BUCKETS; i++) {
+		spinlockInit(&futexBuckets[i].lock, "futex bucket");
+		futexBuckets[i].queues = 0;
+	}
+}
+
+/**
+ * Futexes are keyed by physical address, so the same word mapped into two address spaces is the same futex
+ */
+static unsigned char futexKey(MEM_LOC address, MEM_LOC* key) {
+	MEM_LOC frame;
+
+	if ((address & 0x3) || !getMapping(address, &frame)) {
+		return 0;
+	}
+
+	*key = frame | (address & (PAGE_SIZE - 1));
+	return 1;
+}
+
+static futex_bucket_t* futexBucket(MEM_LOC key) {
+	return &futexBuckets[(key >> 2) % FUTEX_BUCKETS];
+}
+
+static futex_queue_t* futexFind(futex_bucket_t* bucket, MEM_LOC key) {
+
+	for (futex_queue_t* iter = bucket->queues; iter; iter = iter->next) {
+		if (iter->key == key) {
+			return iter;
+		}
+	}
+
+	return 0;
+}
+
+int syscallFutexWait(MEM_LOC address, uint32_t expected, unsigned long timeout) {
+	MEM_LOC key;
+
+	if (!futexKey(address, &key)) {
+		return FUTEX_BAD_ADDRESS;
+	}
+
+	futex_bucket_t* bucket = futexBucket(key);
+	spinlockAcquire(&bucket->lock);
+
+	if (*((volatile uint32_t*) address) != expected) {
+		spinlockRelease(&bucket->lock);
+		return FUTEX_VALUE_CHANGED;
+	}
+
+	futex_queue_t* futex = futexFind(bucket, key);
+
+	if (!futex) {
+		futex = malloc(sizeof(futex_queue_t));
+		memset(futex, 0, sizeof(futex_queue_t));
+		futex->key = key;
+		futex->next = bucket->queues;
+		bucket->queues = futex;
+	}
+
+	futex->waiters++;
+	unsigned char woken = schedulerBlockTimeout(&futex->queue, &bucket->lock, timeout);
+	futex->waiters--;
+
+	if (!futex->waiters) {
+		futex_queue_t** link = &bucket->queues;
+
+		while (*link != futex) {
+			link = &(*link)->next;
+		}
+
+		*link = futex->next;
+		free(futex);
+	}
+
+	spinlockRelease(&bucket->lock);
+	return woken ? FUTEX_WOKEN : FUTEX_TIMED_OUT;
+}
+
+int syscallFutexWake(MEM_LOC address, uint32_t count) {
+	MEM_LOC key;
+
+	if (!futexKey(address, &key)) {
+		return 0;
+	}
+
+	futex_bucket_t* bucket = futexBucket(key);
+	spinlockAcquire(&bucket->lock);
+
+	int woken = 0;
+	futex_queue_t* futex = futexFind(bucket, key);
+
+	if (futex) {
+		while ((uint32_t) woken < count && schedulerWakeOne(&futex->queue)) {
+			woken++;
+		}
+	}
+
+	spinlockRelease(&bucket->lock);
+	return woken;
+}
@@ -0,0 +1,23 @@
+#ifndef _KERNEL_SYSCALL_FUTEX_DEF_H_
+#define _KERNEL_SYSCALL_FUTEX_DEF_H_
+#include <syscall/syscall_futex.h>
+#include <types/stdint.h>
+#include <types/memory.h>
+
+/**
+ * Set up the table of futex wait queues
+ */
+void initializeFutexes();
+
+/**
+ * Syscall - sleep on the futex at address (in the current address space) if it still holds expected, for at most
+ * timeout clock ticks (0 waits forever). Returns one of the FUTEX_ results
+ */
+int syscallFutexWait(MEM_LOC address, uint32_t expected, unsigned long timeout);
+
+/**
+ * Syscall - wake up to count processes sleeping on the futex at address, returns how many were woken
+ */
+int syscallFutexWake(MEM_LOC address, uint32_t count);
+
+#endif //_KERNEL_SYSCALL_FUTEX_DEF_H_
@@ -0,0 +1,253 @@
+#include <syscall/ipc.h>
+#include <scheduler/scheduler.h>
+#include <lock/spinlock.h>
+
+/**
+ * Where a process is in a call
+ */
+#define IPC_IDLE 0
+#define IPC_CALLING 1 //On the callers list of the process it called, waiting to be received
+#define IPC_AWAITING_REPLY 2 //On the received list of the process it called
+#define IPC_RECEIVING 3 //Waiting for a call
+#define IPC_EXITED 4 //On its way out, it can't be called any more
+
+/**
+ * Protects the IPC state of every process. The process being called is pinned when it is looked up, so it isn't freed
+ * while the call is made. Once the caller is on one of its lists ipcProcessExit (which runs before the process can be
+ * reaped) takes it off again, so the caller never has to touch it after that
+ */
+static spinlock_t ipcLock = SPINLOCK_INIT("ipc");
+
+/**
+ * Add the process to the end of a callers or received list
+ */
+static void ipcListAppend(process_t** list, process_t* process) {
+
+	while (*list) {
+		list = &(*list)->ipcNext;
+	}
+
+	process->ipcNext = 0;
+	*list = process;
+}
+
+/**
+ * Take the process with the PID given off a callers or received list, returns 0 if it isn't on it
+ */
+static process_t* ipcListRemove(process_t** list, unsigned int pid) {
+
+	for (; *list; list = &(*list)->ipcNext) {
+		if ((*list)->id == pid) {
+			process_t* process = *list;
+			*list = process->ipcNext;
+			process->ipcNext = 0;
+			return process;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Move the oldest caller of the current process onto its received list and give the current process its message,
+ * returns the PID of the caller or 0 if nobody is calling. ipcLock must be held
+ */
+static unsigned int ipcTakeCaller(process_t* current) {
+	process_t* caller = current->ipcCallers;
+
+	if (!caller) {
+		return 0;
+	}
+
+	current->ipcCallers = caller->ipcNext;
+	ipcListAppend(&current->ipcReceived, caller);
+
+	caller->ipcState = IPC_AWAITING_REPLY;
+	current->ipcMessage = caller->ipcMessage;
+	return caller->id;
+}
+
+/**
+ * Block untill a call is received, returns the PID of the caller. ipcLock must be held
+ */
+static int ipcReceiveLocked(process_t* current) {
+	unsigned int from = ipcTakeCaller(current);
+
+	if (from) {
+		return from;
+	}
+
+	current->ipcState = IPC_RECEIVING;
+
+	while (current->ipcState == IPC_RECEIVING) {
+		schedulerBlock(&current->ipcWait, &ipcLock);
+	}
+
+	return current->ipcFrom;
+}
+
+/**
+ * Give the reply to the process with the PID given, returns it or 0 if it isn't waiting on a reply from the current
+ * process. The caller is still asleep, it has to be woken. ipcLock must be held
+ */
+static process_t* ipcReplyLocked(process_t* current, unsigned int pid, ipc_message_t* reply) {
+	process_t* caller = ipcListRemove(&current->ipcReceived, pid);
+
+	if (!caller) {
+		return 0;
+	}
+
+	caller->ipcMessage = *reply;
+	caller->ipcResult = 0;
+	caller->ipcState = IPC_IDLE;
+	return caller;
+}
+
+int syscallIpcCall(unsigned int pid, ipc_message_t* message) {
+	process_t* current = getCurrentProcess();
+	ipc_message_t msg = *message;
+
+	process_t* server = schedulerPinProcessFromPid(pid);
+
+	if (!server) {
+		return IPC_ERROR_NO_PROCESS;
+	}
+
+	spinlockAcquire(&ipcLock);
+
+	if (server == current || server->ipcState == IPC_EXITED) {
+		spinlockRelease(&ipcLock);
+		processUnpin(server);
+		return IPC_ERROR_NO_PROCESS;
+	}
+
+	current->ipcResult = IPC_ERROR_EXITED;
+
+	if (server->ipcState == IPC_RECEIVING) {
+
+		//The server is waiting, give it the message and the rest of the time slice straight away
+		ipcListAppend(&server->ipcReceived, current);
+		current->ipcState = IPC_AWAITING_REPLY;
+
+		server->ipcMessage = msg;
+		server->ipcFrom = current->id;
+		server->ipcState = IPC_IDLE;
+
+		//It is asleep in syscallIpcReceive, it can't exit (let alone be freed) untill the handoff wakes it
+		processUnpin(server);
+		schedulerBlockHandoff(&current->ipcWait, &ipcLock, server);
+	} else {
+		current->ipcMessage = msg;
+		current->ipcState = IPC_CALLING;
+		ipcListAppend(&server->ipcCallers, current);
+		processUnpin(server);
+	}
+
+	while (current->ipcState != IPC_IDLE) {
+		schedulerBlock(&current->ipcWait, &ipcLock);
+	}
+
+	int result = current->ipcResult;
+	msg = current->ipcMessage;
+
+	spinlockRelease(&ipcLock);
+
+	if (!result) {
+		*message = msg;
+	}
+
+	return result;
+}
+
+int syscallIpcReceive(ipc_message_t* message) {
+	process_t* current = getCurrentProcess();
+
+	spinlockAcquire(&ipcLock);
+
+	int from = ipcReceiveLocked(current);
+	ipc_message_t msg = current->ipcMessage;
+
+	spinlockRelease(&ipcLock);
+
+	*message = msg;
+	return from;
+}
+
+int syscallIpcReply(unsigned int pid, ipc_message_t* message) {
+	process_t* current = getCurrentProcess();
+	ipc_message_t reply = *message;
+
+	spinlockAcquire(&ipcLock);
+
+	process_t* caller = ipcReplyLocked(current, pid, &reply);
+
+	if (caller) {
+		schedulerWakeOne(&caller->ipcWait);
+	}
+
+	spinlockRelease(&ipcLock);
+	return caller ? 0 : IPC_ERROR_NOT_CALLING;
+}
+
+int syscallIpcReplyReceive(unsigned int pid, ipc_message_t* message) {
+	process_t* current = getCurrentProcess();
+	ipc_message_t reply = *message;
+
+	spinlockAcquire(&ipcLock);
+
+	process_t* caller = ipcReplyLocked(current, pid, &reply);
+
+	if (!caller) {
+		spinlockRelease(&ipcLock);
+		return IPC_ERROR_NOT_CALLING;
+	}
+
+	int from = ipcTakeCaller(current);
+
+	if (from) {
+		schedulerWakeOne(&caller->ipcWait);
+	} else {
+
+		//Nobody else is calling, wait for the next call on the way back to the caller
+		current->ipcState = IPC_RECEIVING;
+		schedulerBlockHandoff(&current->ipcWait, &ipcLock, caller);
+
+		while (current->ipcState == IPC_RECEIVING) {
+			schedulerBlock(&current->ipcWait, &ipcLock);
+		}
+
+		from = current->ipcFrom;
+	}
+
+	ipc_message_t msg = current->ipcMessage;
+
+	spinlockRelease(&ipcLock);
+
+	*message = msg;
+	return from;
+}
+
+void ipcProcessExit(process_t* process) {
+	spinlockAcquire(&ipcLock);
+
+	process->ipcState = IPC_EXITED;
+
+	//The callers are left with the IPC_ERROR_EXITED they started out with
+	process_t* lists[2] = { process->ipcCallers, process->ipcReceived };
+
+	for (unsigned int i = 0; i < 2; i++) {
+		while (lists[i]) {
+			process_t* caller = lists[i];
+			lists[i] = caller->ipcNext;
+
+			caller->ipcNext = 0;
+			caller->ipcState = IPC_IDLE;
+			schedulerWakeOne(&caller->ipcWait);
+		}
+	}
+
+	process->ipcCallers = 0;
+	process->ipcReceived = 0;
+
+	spinlockRelease(&ipcLock);
+}
@@ -0,0 +1,38 @@
+#ifndef _KERNEL_SYSCALL_IPC_DEF_H_
+#define _KERNEL_SYSCALL_IPC_DEF_H_
+#include <syscall/syscall_ipc.h>
+
+struct processStructure;
+
+/**
+ * Syscall - send the message to the process with the PID given and block untill it replies, the reply is copied
+ * back into message. Returns 0 or one of the IPC_ERROR codes
+ */
+int syscallIpcCall(unsigned int pid, ipc_message_t* message);
+
+/**
+ * Syscall - block untill a process calls this one (taking the oldest waiting call if there are any) and copy its
+ * message into message. Returns the PID of the caller, which is waiting for a reply
+ */
+int syscallIpcReceive(ipc_message_t* message);
+
+/**
+ * Syscall - reply to the call received from the process with the PID given, waking it. Returns 0 or one of the
+ * IPC_ERROR codes
+ */
+int syscallIpcReply(unsigned int pid, ipc_message_t* message);
+
+/**
+ * Syscall - reply to the call received from the process with the PID given and receive the next call, switching
+ * straight back to the caller if none is waiting. Returns the PID of the next caller or one of the IPC_ERROR codes
+ * (without receiving) if the reply couldn't be made
+ */
+int syscallIpcReplyReceive(unsigned int pid, ipc_message_t* message);
+
+/**
+ * Fail every call the process given has not replied to yet and stop it being called, it must be the current process
+ * and on its way out
+ */
+void ipcProcessExit(struct processStructure* process);
+
+#endif //_KERNEL_SYSCALL_IPC_DEF_H_
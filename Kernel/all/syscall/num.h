@@ -3,6 +3,6 @@
 #ifndef _NUM_SYSCALLS_DEF_H_
 #define _NUM_SYSCALLS_DEF_H_
 
-#define KERNEL_NUM_SYSCALLS 23
+#define KERNEL_NUM_SYSCALLS 49
 
 #endif //_NUM_SYSCALLS_DEF_H_
@@ -3,20 +3,111 @@
 #include <process/postbox.h>
 #include <process/message.h>
 #include <scheduler/scheduler.h>
+#include <process/subscriptions.h>
+#include <process/grant.h>
+#include <process/events.h>
+
+//Messages are read out of the postbox this many at a time, their grants have to be mapped before they are copied out
+#define POSTBOX_READ_CHUNK 8
 
 unsigned char postboxHasNext() {
-	return !postboxEmpty(&getCurrentProcess()->processPostbox);
+	return !postboxEmpty(&processLeader(getCurrentProcess())->processPostbox);
 }
 
 void postboxReadTop(process_message* message) {
-	postboxPeek(&getCurrentProcess()->processPostbox, message);
+	process_message msg;
+
+	//Pages granted with the message are only mapped once it is popped
+	if (postboxPeek(&processLeader(getCurrentProcess())->processPostbox, &msg)) {
+		msg.messageAdditionalData = 0;
+		msg.grantFrames = 0;
+		*message = msg;
+	}
 }
 
 void postboxPopTop() {
 	process_message toTest;
-	postboxTop(&getCurrentProcess()->processPostbox, &toTest);
+
+	if (postboxTop(&processLeader(getCurrentProcess())->processPostbox, &toTest)) {
+		grantDiscard(&toTest);
+	}
+}
+
+unsigned int postboxReadBatch(process_message* buffer, unsigned int max) {
+	process_postbox* pb = &processLeader(getCurrentProcess())->processPostbox;
+	process_message chunk[POSTBOX_READ_CHUNK];
+	unsigned int copied = 0;
+
+	while (copied < max) {
+		unsigned int wanted = max - copied < POSTBOX_READ_CHUNK ? max - copied : POSTBOX_READ_CHUNK;
+		unsigned int read = postboxTopBatch(pb, chunk, wanted);
+
+		for (unsigned int i = 0; i < read; i++) {
+			grantDeliver(&chunk[i]);
+			buffer[copied++] = chunk[i];
+		}
+
+		if (read != wanted) {
+			break;
+		}
+	}
+
+	return copied;
+}
+
+unsigned char postboxWait(unsigned long ticks) {
+	return postboxWaitForMessage(&processLeader(getCurrentProcess())->processPostbox, ticks);
 }
 
 void postboxSetFlags(uint32_t flags) {
-	getCurrentProcess()->postboxFlags = flags;
+	subscriptionsSetFlags(processLeader(getCurrentProcess()), flags);
+}
+
+int postboxBroadcast(process_message* message, uint32_t bit) {
+
+	//Anything else (input especially) would let a process pass off its messages as the kernel's
+	if (bit != BROADCAST_BIT) {
+		return POSTBOX_ERROR_BAD_EVENT;
+	}
+
+	process_message msg = *message;
+	msg.from_PID = processLeader(getCurrentProcess())->id;
+	msg.grantPages = 0;
+	msg.grantFrames = 0;
+
+	subscriptionsBroadcast(&msg, bit);
+	return 0;
+}
+
+int postboxSend(unsigned int pid, process_message* message, MEM_LOC address, unsigned int pages) {
+	process_message msg = *message;
+	msg.from_PID = processLeader(getCurrentProcess())->id;
+
+	process_t* process = schedulerPinProcessFromPid(pid);
+
+	if (!process) {
+		return POSTBOX_ERROR_NO_PROCESS;
+	}
+
+	//Pin the leader (kept alive by the pinned process) instead, a thread exiting while its sender waits for room in
+	//the postbox it shares shouldn't hold up the reaper
+	process_t* leader = processLeader(process);
+	unsigned char exiting = process->shouldDestroy;
+
+	processPin(leader);
+	processUnpin(process);
+
+	int error = exiting ? POSTBOX_ERROR_NO_PROCESS : grantAttach(&msg, address, pages);
+
+	if (!error && !postboxPushWait(&leader->processPostbox, &msg)) {
+		grantDiscard(&msg);
+		error = POSTBOX_ERROR_FULL;
+	}
+
+	processUnpin(leader);
+	return error;
+}
+
+void postboxSetPolicy(unsigned int limit, unsigned char policy) {
+	postboxSetLimit(&processLeader(getCurrentProcess())->processPostbox, limit, policy);
 }
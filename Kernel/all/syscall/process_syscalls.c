@@ -1,6 +1,7 @@
 #include <types/memory.h>
 #include <process/process.h>
 #include <scheduler/scheduler.h>
+#include <process/accounting.h>
 
 unsigned char syscallProcessValid(unsigned int pid)
 {
@@ -48,6 +49,19 @@ unsigned long syscallGetProcessingTime(unsigned int pid)
 	return iterator->processingTime;
 }
 
+unsigned char syscallGetCpuTime(unsigned int pid, process_info_t* info)
+{
+	process_t* process = schedulerPinProcessFromPid(pid);
+
+	if (!process) return 0;
+
+	accountingFillInfo(process, info);
+	postboxFillInfo(&processLeader(process)->processPostbox, info);
+
+	processUnpin(process);
+	return 1;
+}
+
 void syscallGetName(char* StrLocation, unsigned int pid)
 {	
 	//Iterate untill found the correct PID
@@ -82,3 +96,8 @@ void syscallRequestExit(int returnValue)
 	getCurrentProcess()->returnValue = returnValue;
 	schedulerKillCurrentProcess();
 }
+
+int syscallWaitProcess(unsigned int pid)
+{
+	return schedulerWaitForExit(pid);
+}
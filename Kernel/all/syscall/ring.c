@@ -0,0 +1,139 @@
+#include <syscall/ring.h>
+#include <scheduler/scheduler.h>
+#include <process/process_info.h>
+#include <interrupts/interrupts.h>
+#include <lock/atomic.h>
+#include <fs/vfs.h>
+#include <process/accounting.h>
+#include <process/grant.h>
+#include <process/poll.h>
+
+extern void syscallPrint_t(const char* Line);
+
+static sint32_t ringProcessInfo(unsigned int iter, process_info_t* info) {
+	process_t* process = schedulerPinProcess(iter);
+
+	if (!process) {
+		return 0;
+	}
+
+	info->pID = process->id;
+	info->processingTime = process->processingTime;
+	accountingFillInfo(process, info);
+	postboxFillInfo(&processLeader(process)->processPostbox, info);
+	strcpy(info->Name, process->name);
+
+	processUnpin(process);
+	return 1;
+}
+
+static sint32_t ringFileRead(process_t* process, syscall_ring_submission_t* op) {
+	fs_node_t* node = evaluatePath((const char*) op->params[0], processLeader(process)->executionDirectory);
+
+	if (!node) {
+		return -1;
+	}
+
+	return read_fs(node, op->params[1], op->params[2], (uint8_t*) op->params[3]);
+}
+
+static sint32_t ringPostboxRead(process_t* process, process_message* dest) {
+	process_message msg;
+
+	if (!postboxTop(&processLeader(process)->processPostbox, &msg)) {
+		return 0;
+	}
+
+	grantDeliver(&msg);
+	*dest = msg;
+	return 1;
+}
+
+static sint32_t ringExecute(process_t* process, syscall_ring_submission_t* op) {
+	switch (op->opcode) {
+	case SYSCALL_RING_PRINT:
+		syscallPrint_t((const char*) op->params[0]);
+		return 0;
+	case SYSCALL_RING_POSTBOX_READ:
+		return ringPostboxRead(process, (process_message*) op->params[0]);
+	case SYSCALL_RING_PROCESS_INFO:
+		return ringProcessInfo(op->params[0], (process_info_t*) op->params[1]);
+	case SYSCALL_RING_FILE_READ:
+		return ringFileRead(process, op);
+	case SYSCALL_RING_SLEEP:
+		schedulerSleep(op->params[0]);
+		return 0;
+	default:
+		return -1;
+	}
+}
+
+/**
+ * Carry out submissions untill there are none left or there is no room for their completions
+ */
+static int ringProcess(process_t* process, syscall_ring_t* ring) {
+	int processed = 0;
+
+	while (ring->submissionHead != ring->submissionTail
+			&& ring->completionTail - ring->completionHead < SYSCALL_RING_ENTRIES) {
+
+		syscall_ring_submission_t op = ring->submissions[ring->submissionHead & SYSCALL_RING_MASK];
+		ring->submissionHead++;
+
+		syscall_ring_completion_t* completion = &ring->completions[ring->completionTail & SYSCALL_RING_MASK];
+		completion->userData = op.userData;
+		completion->result = ringExecute(process, &op);
+
+		//The completion has to be written before the process can see it
+		compilerBarrier();
+		ring->completionTail++;
+		processed++;
+	}
+
+	if (processed) {
+		pollRingCompleted(process);
+	}
+
+	return processed;
+}
+
+int syscallRingRegister(syscall_ring_t* ring, uint32_t flags) {
+	process_t* process = getCurrentProcess();
+
+	if (ring) {
+		ring->flags = flags;
+	}
+
+	process->syscallRing = ring;
+	return 1;
+}
+
+int syscallRingEnter() {
+	process_t* process = getCurrentProcess();
+
+	if (!process->syscallRing) {
+		return 0;
+	}
+
+	return ringProcess(process, process->syscallRing);
+}
+
+void syscallRingPoll() {
+	process_t* process = getCurrentProcess();
+	syscall_ring_t* ring = process->syscallRing;
+
+	//Ticks interrupt kernel code as well, the ring can only be touched if the process was running its own code
+	if (!ring || !(ring->flags & SYSCALL_RING_POLL) || process->syscallDepth || PERCPU_READ(preemptCount)
+			|| ring->submissionHead == ring->submissionTail) {
+		return;
+	}
+
+	//Service it like a syscall, the tick interrupt has already been acknowledged so interrupts can go back on
+	process->syscallDepth++;
+	enableInterrupts();
+
+	ringProcess(process, ring);
+
+	disableInterrupts();
+	process->syscallDepth--;
+}
@@ -0,0 +1,21 @@
+#ifndef _KERNEL_SYSCALL_RING_DEF_H_
+#define _KERNEL_SYSCALL_RING_DEF_H_
+#include <syscall/syscall_ring.h>
+
+/**
+ * Syscall - register ring (in the current process's address space) as its syscall ring, 0 removes it. flags are
+ * SYSCALL_RING_ flags. Returns 1
+ */
+int syscallRingRegister(syscall_ring_t* ring, uint32_t flags);
+
+/**
+ * Syscall - carry out everything waiting on the current process's ring, returns the number of operations completed
+ */
+int syscallRingEnter();
+
+/**
+ * Called on every tick of a process, services its ring if it is polling and isn't in the middle of a syscall
+ */
+void syscallRingPoll();
+
+#endif //_KERNEL_SYSCALL_RING_DEF_H_
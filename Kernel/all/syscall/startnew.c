@@ -3,6 +3,12 @@
 #include <scheduler/scheduler.h>
 #include <debug/debug.h>
 
-void syscallRequestRunNewProcess(const char* executablePath) {
-	createNewProcess(executablePath, getCurrentProcess()->executionDirectory);
+int syscallRequestRunNewProcess(const char* executablePath) {
+	return createNewProcess(executablePath, processLeader(getCurrentProcess())->executionDirectory, HANDLE_NONE,
+			HANDLE_NONE);
+}
+
+int syscallRequestRunRedirected(const char* executablePath, int stdinHandle, int stdoutHandle) {
+	return createNewProcess(executablePath, processLeader(getCurrentProcess())->executionDirectory, stdinHandle,
+			stdoutHandle);
 }
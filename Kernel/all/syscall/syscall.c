@@ -8,11 +8,22 @@
 #include <interrupts/interrupt_handler.h>
 #include <input/keyboard.h>
 #include <syscall/num.h>
+#include <syscall/ring.h>
+#include <syscall/futex.h>
+#include <syscall/ipc.h>
+#include <process/handles.h>
+#include <process/poll.h>
+#include <process/process_info.h>
 
 extern unsigned char postboxHasNext();
 extern void postboxReadTop(process_message* Message);
 extern void postboxPopTop();
 extern void postboxSetFlags(uint32_t bit);
+extern unsigned int postboxReadBatch(process_message* buffer, unsigned int max);
+extern unsigned char postboxWait(unsigned long ticks);
+extern int postboxBroadcast(process_message* message, uint32_t bit);
+extern int postboxSend(unsigned int pid, process_message* message, MEM_LOC address, unsigned int pages);
+extern void postboxSetPolicy(unsigned int limit, unsigned char policy);
 extern void syscallKillCurrentProcess();
 extern void syscallRequestExit(int returnValue);
 
@@ -20,7 +31,10 @@ extern unsigned char syscallProcessValid(unsigned int iter);
 extern unsigned int syscallGetPid(unsigned int iter);
 extern unsigned long syscallGetProcessingTime(unsigned int iter);
 extern void syscallGetName(char* StrLocation, unsigned int iter);
-extern void syscallRequestRunNewProcess(const char* NewProcess);
+extern unsigned char syscallGetCpuTime(unsigned int pid, process_info_t* info);
+extern int syscallRequestRunNewProcess(const char* NewProcess);
+extern int syscallWaitProcess(unsigned int pid);
+extern int syscallRequestRunRedirected(const char* executablePath, int stdinHandle, int stdoutHandle);
 
 char getKeyMapping(unsigned char scancode, unsigned long flags) {
 	return lookupAsciCharacterFromScancode(scancode, flags);
@@ -73,6 +87,32 @@ void kernelInitializeSyscalls() {
 	kernelRegisterSyscall(18, syscallGetProcessingTime); //Syscall 18 - Get the processing time of the process
 	kernelRegisterSyscall(19, syscallGetName); //Syscall 19 - Get the name of the process linked to the iterator
 	kernelRegisterSyscall(20, syscallRequestExit); //Syscall 20 - Request exit of the current process (Supplied argument is used as the return value)
-	kernelRegisterSyscall(21, syscallRequestRunNewProcess); //Syscall 21 - Requests the execution of a new application (char* filename supplied)
+	kernelRegisterSyscall(21, syscallRequestRunNewProcess); //Syscall 21 - Requests the execution of a new application (char* filename supplied), returns its PID
 	kernelRegisterSyscall(22, syscallSetDebugMode); //Syscall 22 - Requests the kernel change the debug mode to on or off
+	kernelRegisterSyscall(23, syscallWaitProcess); //Syscall 23 - Block untill the process with the PID given exits, returns its return value
+	kernelRegisterSyscall(24, syscallFastEntryAvailable); //Syscall 24 - Can syscalls be made through the fast entry (sysenter on ia32)?
+	kernelRegisterSyscall(25, syscallRingRegister); //Syscall 25 - Register (or with 0 remove) the syscall ring of the process
+	kernelRegisterSyscall(26, syscallRingEnter); //Syscall 26 - Carry out every operation waiting on the syscall ring, returns how many were
+	kernelRegisterSyscall(27, createThread); //Syscall 27 - Start a thread sharing the address space of the process (entry, argument, stack, TLS block), returns its ID
+	kernelRegisterSyscall(28, setThreadTls); //Syscall 28 - Move the TLS segment (fs) of the calling thread to the block given
+	kernelRegisterSyscall(29, syscallFutexWait); //Syscall 29 - Sleep on the futex given if it holds the value expected (with a timeout in ticks, 0 for none)
+	kernelRegisterSyscall(30, syscallFutexWake); //Syscall 30 - Wake up to the number given of the processes sleeping on a futex, returns how many were woken
+	kernelRegisterSyscall(31, syscallGetCpuTime); //Syscall 31 - Fill in the user time, kernel time and CPU usage of the process with the PID given
+	kernelRegisterSyscall(32, postboxReadBatch); //Syscall 32 - Pop up to the number given of messages from the postbox into a buffer, returns how many were
+	kernelRegisterSyscall(33, postboxWait); //Syscall 33 - Block untill the postbox has a message (with a timeout in ticks, 0 for none), returns 1 if one is waiting
+	kernelRegisterSyscall(34, postboxBroadcast); //Syscall 34 - Send a message to every process subscribed to BROADCAST_BIT
+	kernelRegisterSyscall(35, syscallIpcCall); //Syscall 35 - Send a message to the process with the PID given and block untill it replies
+	kernelRegisterSyscall(36, syscallIpcReceive); //Syscall 36 - Block untill a process calls, returns its PID
+	kernelRegisterSyscall(37, syscallIpcReply); //Syscall 37 - Reply to the call received from the process with the PID given
+	kernelRegisterSyscall(38, syscallIpcReplyReceive); //Syscall 38 - Reply to a call and receive the next one, returns the PID of the next caller
+	kernelRegisterSyscall(39, postboxSend); //Syscall 39 - Send a message to the process with the PID given, moving the pages given (address, count) to it
+	kernelRegisterSyscall(40, postboxSetPolicy); //Syscall 40 - Set the most messages the postbox holds and what happens to messages sent once it is full
+	kernelRegisterSyscall(41, handlesCreatePipe); //Syscall 41 - Create a pipe, putting the handles of its read and write ends in the array given
+	kernelRegisterSyscall(42, handlesRead); //Syscall 42 - Read from a handle (handle, buffer, length, flags), returns the number of bytes read
+	kernelRegisterSyscall(43, handlesWrite); //Syscall 43 - Write to a handle (handle, buffer, length, flags), returns the number of bytes written
+	kernelRegisterSyscall(44, handlesClose); //Syscall 44 - Close a handle
+	kernelRegisterSyscall(45, syscallRequestRunRedirected); //Syscall 45 - Run a new application with the handles given as its input and output, returns its PID
+	kernelRegisterSyscall(46, pollAdd); //Syscall 46 - Register interest in an event source (source, id, events, user data), returns the registration
+	kernelRegisterSyscall(47, pollRemove); //Syscall 47 - Remove a registration
+	kernelRegisterSyscall(48, pollWait); //Syscall 48 - Block untill registered sources are ready (events, max, timeout in ticks), returns how many were copied
 }
@@ -6,6 +6,9 @@
 //Architecture specific, each arch may initialze in a different way (Look in the arch folders)
 void kernelInitializeSyscallSystem();
 
+//Architecture specific, returns 1 if processes can make syscalls through the architectures fast entry instead of the interrupt
+unsigned char syscallFastEntryAvailable();
+
 //Architecture general, initializes syscalls to the correct positions
 void kernelInitializeSyscalls();
 
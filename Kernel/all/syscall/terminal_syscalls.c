@@ -4,14 +4,24 @@
 #include <heap/heap.h>
 #include <panic/panic.h>
 #include <mm/virt_mm.h>
+#include <process/handles.h>
 
 void syscallPrint_t(const char* Line)
 {
-	if (getCurrentProcess()->processTerminal != 0)
+	//Output goes down the pipe the process was given instead, if nothing reads it any more it is thrown away
+	if (handlesOpen(HANDLE_STDOUT))
+	{
+		handlesWrite(HANDLE_STDOUT, (const uint8_t*) Line, strlen(Line), 0);
+		return;
+	}
+
+	terminal_t* terminal = getCurrentProcess()->processTerminal;
+
+	if (terminal != 0)
 	{
 		while (*Line)
 		{
-			getCurrentProcess()->processTerminal->f_putchar(getCurrentProcess()->processTerminal, *Line);
+			terminal->f_putchar(terminal, *Line);
 			Line++;
 		}
 	}
@@ -19,24 +29,30 @@ void syscallPrint_t(const char* Line)
 
 void syscallClearscreen()
 {
-	if (getCurrentProcess()->processTerminal != 0)
+	terminal_t* terminal = getCurrentProcess()->processTerminal;
+
+	if (terminal != 0)
 	{
-		getCurrentProcess()->processTerminal->f_clear(getCurrentProcess()->processTerminal);
+		terminal->f_clear(terminal);
 	}
 }
 
 void syscallSetFgc(unsigned char fgc)
 {
-	if (getCurrentProcess()->processTerminal != 0)
+	terminal_t* terminal = getCurrentProcess()->processTerminal;
+
+	if (terminal != 0)
 	{
-		getCurrentProcess()->processTerminal->f_setForeground(getCurrentProcess()->processTerminal, fgc);
-	}	
+		terminal->f_setForeground(terminal, fgc);
+	}
 }
 
 void syscallSetBgc(unsigned char bgc)
 {
-	if (getCurrentProcess()->processTerminal != 0)
+	terminal_t* terminal = getCurrentProcess()->processTerminal;
+
+	if (terminal != 0)
 	{
-		getCurrentProcess()->processTerminal->f_setBackground(getCurrentProcess()->processTerminal, bgc);
-	}	
+		terminal->f_setBackground(terminal, bgc);
+	}
 }
@@ -0,0 +1,76 @@
+#include <system/kernel_data_page.h>
+#include <clock/clock.h>
+#include <mm/virtual.h>
+#include <mm/physical.h>
+#include <cpu/cpu.h>
+#include <cpu/percpu.h>
+#include <lock/atomic.h>
+#include <types/memory.h>
+
+//The TSC is calibrated against this many ticks once the page is up
+#define TSC_CALIBRATION_TICKS 100
+
+static kernel_data_page_t* dataPage = 0;
+static unsigned char tscSupported = 0;
+static unsigned long calibrationStartTick = 0;
+static uint64_t calibrationStartTsc = 0;
+
+void initializeKernelDataPage() {
+
+	//Kernel page tables are shared by every page directory, so mapping it once maps it everywhere. It is restricted
+	//(read only from user mode) but the kernel can still write to it
+	map(KERNEL_DATA_PAGE_ADDRESS, allocateFrame(), MEMORY_RESTRICTED_ACCESS);
+
+	dataPage = (kernel_data_page_t*) KERNEL_DATA_PAGE_ADDRESS;
+	memset(dataPage, 0, PAGE_SIZE);
+
+	dataPage->ticks = getClockTicks();
+	dataPage->ticksPerSecond = CLOCKS_PER_SECOND;
+	dataPage->numProcesses = 1;
+	dataPage->onlineCpus = 1;
+
+	tscSupported = cpuidHasFeature(CPUID_FEATURE_TSC);
+
+	if (tscSupported) {
+		calibrationStartTick = getClockTicks();
+		calibrationStartTsc = readTimestampCounter();
+	}
+}
+
+kernel_data_page_t* kernelDataPage() {
+	return dataPage;
+}
+
+void kernelDataPageTick() {
+
+	if (!dataPage) {
+		return;
+	}
+
+	uint64_t tsc = tscSupported ? readTimestampCounter() : 0;
+	unsigned long ticks = getClockTicks();
+
+	unsigned int online = 0;
+
+	for (unsigned int i = 0; i < cpuCount(); i++) {
+		if (cpuGet(i)->online) {
+			online++;
+		}
+	}
+
+	dataPage->sequence++;
+	compilerBarrier();
+
+	dataPage->ticks = ticks;
+	dataPage->tscAtLastTick = tsc;
+
+	if (tscSupported && !dataPage->tscPerTick && ticks - calibrationStartTick >= TSC_CALIBRATION_TICKS) {
+		dataPage->tscPerTick = cyclesDivide(tsc - calibrationStartTsc, ticks - calibrationStartTick);
+	}
+
+	dataPage->freeFrames = calculateFreeFrames();
+	dataPage->onlineCpus = online;
+
+	compilerBarrier();
+	dataPage->sequence++;
+}
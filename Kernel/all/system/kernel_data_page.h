@@ -0,0 +1,20 @@
+#ifndef _KERNEL_DATA_PAGE_KERNEL_DEF_H_
+#define _KERNEL_DATA_PAGE_KERNEL_DEF_H_
+#include <system/kernel_data.h>
+
+/**
+ * Allocate and map the kernel data page, has to happen before the first process is created
+ */
+void initializeKernelDataPage();
+
+/**
+ * Update the kernel data page, called by the clock on every tick
+ */
+void kernelDataPageTick();
+
+/**
+ * Returns the kernel data page so the kernel can update its counters (0 before it is initialized)
+ */
+kernel_data_page_t* kernelDataPage();
+
+#endif //_KERNEL_DATA_PAGE_KERNEL_DEF_H_
@@ -6,6 +6,7 @@
 #include <scheduler/scheduler.h>
 #include <settings/settingsmanager.h>
 #include <interrupts/interrupts.h>
+#include <process/grant.h>
 
 process_t* systemIdlePtr = 0;
 process_t* systemProcPtr = 0;
@@ -20,7 +21,7 @@ void systemIdleProcess() {
 void systemMainProcess() {
 
 	//Create the process set as onstart in the global settings
-	createNewProcess(settingsReadValue("system.on_boot", "/system/Line"), get_vfs());
+	createNewProcess(settingsReadValue("system.on_boot", "/system/Line"), get_vfs(), HANDLE_NONE, HANDLE_NONE);
 
 	//Enable interrupts
 	enableInterrupts();
@@ -28,7 +29,7 @@ void systemMainProcess() {
 	//Store a pointer to the current process to be used when checking close requests
 	systemProcPtr = getCurrentProcess();
 
-	//Loop and continually halt the processor, this will cause the processor to idle between interrupts
+	//Sleep untill a process exits, then free it. The scheduler wakes this process whenever a process is killed
 	for (;;) {
 
 		process_message msg;
@@ -37,73 +38,36 @@ void systemMainProcess() {
 		while (postboxTop(&getCurrentProcess()->processPostbox, &msg)) {
 			//TODO: Do something
 			DEBUG_PRINT("System has recieved a message");
+			grantDiscard(&msg);
 		}
 
-		int numNonSystem = 0;
-		int schedulerIter = 0;
-		process_t* schedulerPtr;
+		//The zombie comes back already removed from the scheduler
+		process_t* zombie = schedulerWaitForZombie();
 
-		//Shut down all processes that need a-killin
-		while (schedulerPtr = schedulerReturnProcess(schedulerIter)) {
+		if ((zombie == systemIdlePtr) || (zombie == systemProcPtr)) {
+			DEBUG_PRINT("Cannot close SystemIdle or System\n");
+			zombie->shouldDestroy = 0;
+		} else {
+			DEBUG_PRINT("Process %i (%s) terminated with return value %i\n",
+					zombie->id, zombie->name, zombie->returnValue);
 
-			if (schedulerPtr->shouldDestroy == 1) {
-
-				//Must remove this process and kill it! so disable interrupts don't wanna be interrupted
-				disableInterrupts();
-
-				if ((schedulerPtr == systemIdlePtr)
-						|| (schedulerPtr == systemProcPtr)) {
-					DEBUG_PRINT("Cannot close SystemIdle or System\n");
-					schedulerPtr->shouldDestroy = 0;
-				} else {
-					DEBUG_PRINT(
-							"Process %i (%s) terminated with return value %i\n",
-							schedulerPtr->id, schedulerPtr->name,
-							schedulerPtr->returnValue);
-
-					schedulerRemove(schedulerPtr);
-
-					DEBUG_PRINT(
-							"Freeing process %x (%i:%s) current process %i\n",
-							schedulerPtr, schedulerPtr->id,
-							schedulerPtr->name, getCurrentProcess()->id);
-					freeProcess(schedulerPtr);
-
-				}
-
-				//Enable interrupts once the deed is done
-				enableInterrupts();
-			}
-
-			//Count up the number of non system processes (To check there is a interface active)
-			if (schedulerPtr != systemIdlePtr && schedulerPtr != systemProcPtr) {
-				numNonSystem++;
-			}
-
-			schedulerIter++;
+			DEBUG_PRINT("Freeing process %x (%i:%s) current process %i\n",
+					zombie, zombie->id, zombie->name, getCurrentProcess()->id);
+			freeProcess(zombie);
 		}
 
-		//If this is the last process alive?
-		if (numNonSystem == 0) {
+		//If this is the last process alive? (The System process is the only one left on the scheduler)
+		if (schedulerNumProcesses() == 1) {
 
 			//Is the system set to restart the boot program when there are no other active programs
 			if (strcmp(settingsReadValue("system.boot_program_keep_alive", "yes"), "yes") == 0) {
 
-				//Disable interrupts while the new process is being created
-				disableInterrupts();
-
 				DEBUG_PRINT("Creating new instance of %s\n", settingsReadValue("system.on_boot", "/system/Line"));
 
 				//Create the new process with the program set as system.on_boot
-				createNewProcess(settingsReadValue("system.on_boot", "/system/Line"), get_vfs());
-
-				//Re enable them once your done
-				enableInterrupts();
+				createNewProcess(settingsReadValue("system.on_boot", "/system/Line"), get_vfs(), HANDLE_NONE, HANDLE_NONE);
 			}
-
 		}
-
-		schedulerYield();
 	}
 }
 
@@ -1,10 +1,15 @@
 //Kernel Terminal
 #include <terminal/terminal.h>
 #include <stdio.h>
+#include <lock/spinlock.h>
 
 terminal_t* g_kernelTerminal = 0;
 terminal_t* g_terminalInContext = 0;
 
+//Every terminal draws through the one set of screen cursors and video memory. Anything can print, interrupt handlers
+//included, so the lock is taken with interrupts off
+static spinlock_t terminalLock = SPINLOCK_INIT("terminal");
+
 void setTerminalContext(terminal_t* term);
 
 terminal_t* getTerminalInContext()
@@ -14,33 +19,45 @@ terminal_t* getTerminalInContext()
 
 void kernel_terminal_putc(terminal_t* term, char c)
 {
+	irq_flags_t flags = spinlockAcquireIrqSave(&terminalLock);
+
 	if (term == g_terminalInContext) {
 		text_mode_tputc(term, c);
 	} else {
 		//Write to the backup data which stores a copy of the terminal when its not in context
 		text_mode_putc_prec(term->m_backupData, term->m_backgroundColour, term->m_foregroundColour, &term->m_cursorX, &term->m_cursorY, c);
 	}
+
+	spinlockReleaseIrqRestore(&terminalLock, flags);
 }
 
 void kernel_terminal_setfg(terminal_t* term, uint8_t col)
 {
+	irq_flags_t flags = spinlockAcquireIrqSave(&terminalLock);
 	term->m_foregroundColour = col;
 
 	if (term == g_terminalInContext) {
 		text_mode_tsetfg(term, col);
 	}
+
+	spinlockReleaseIrqRestore(&terminalLock, flags);
 }
 
 void kernel_terminal_setbg(terminal_t* term, uint8_t col)
 {
+	irq_flags_t flags = spinlockAcquireIrqSave(&terminalLock);
 	term->m_backgroundColour = col;
 
 	if (term == g_terminalInContext) {
 		text_mode_tsetbg(term, col);
 	}
+
+	spinlockReleaseIrqRestore(&terminalLock, flags);
 }
 
 void kernel_terminal_clear(terminal_t* term) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&terminalLock);
+
 	if (term == g_terminalInContext) {
 		text_mode_tclear(term);
 	}
@@ -49,12 +66,18 @@ void kernel_terminal_clear(terminal_t* term) {
 		//Clear the screen using the direct video memory access on the backup data
 		text_mode_clearscreen_prec(term->m_backupData, term->m_backgroundColour, &term->m_cursorX, &term->m_cursorY);
 	}
+
+	spinlockReleaseIrqRestore(&terminalLock, flags);
 }
 
 void kernel_terminal_update_cursor(terminal_t* term) {
+	irq_flags_t flags = spinlockAcquireIrqSave(&terminalLock);
+
 	if (term == g_terminalInContext) {
 		text_mode_tup(term);
 	}
+
+	spinlockReleaseIrqRestore(&terminalLock, flags);
 }
 
 void kputc(char c);
@@ -81,8 +104,10 @@ void setDefaultTerminalCallbacks(terminal_t* term)
 
 void setTerminalContext(terminal_t* term)
 {
+	irq_flags_t flags = spinlockAcquireIrqSave(&terminalLock);
 	g_terminalInContext = term;
 	text_mode_sett(term);
+	spinlockReleaseIrqRestore(&terminalLock, flags);
 }
 
 //Clear the kernel terminals screen
@@ -100,7 +125,9 @@ void kputc(char c)
 	if (g_kernelTerminal == 0)
 	{
 
+		irq_flags_t flags = spinlockAcquireIrqSave(&terminalLock);
 		text_mode_putc(c);
+		spinlockReleaseIrqRestore(&terminalLock, flags);
 
 	}
 	else
@@ -114,14 +141,20 @@ void kputc(char c)
 //Move the X cursor on the kernel terminal
 void kmovecx(unsigned int x)
 {
+	irq_flags_t flags = spinlockAcquireIrqSave(&terminalLock);
 	g_kernelTerminal->m_cursorX = x;
+	spinlockReleaseIrqRestore(&terminalLock, flags);
+
 	g_kernelTerminal->f_updateCursor(g_kernelTerminal);
 }
 
 //Move the Y cursor on the kernel terminal
 void kmovecy(unsigned int y)
 {
+	irq_flags_t flags = spinlockAcquireIrqSave(&terminalLock);
 	g_kernelTerminal->m_cursorY = y;
+	spinlockReleaseIrqRestore(&terminalLock, flags);
+
 	g_kernelTerminal->f_updateCursor(g_kernelTerminal);
 }
 
@@ -22,6 +22,7 @@
 #include <scheduler/scheduler.h>
 #include <input/input.h>
 #include <syscall/syscall.h>
+#include <syscall/futex.h>
 #include <settings/settingsmanager.h>
 #include <devices/devices.h>
 #include <terminal/kterminal.h>
@@ -29,6 +30,9 @@
 #include <screen/screen.h>
 #include <heap/kheap.h>
 #include <gpf/gpf.h>
+#include <cpu/fpu.h>
+#include <system/kernel_data_page.h>
+#include <process/accounting.h>
 #include <stack/stack.h>
 
 #include <fs/vfs.h>
@@ -124,7 +128,10 @@ void initializeKernel(struct multiboot* mboot_ptr, uint32_t initial_esp) {
 	initializeDevices();
 	initializeScreen();
 	initializeGeneralProtectionFaultHandler();
+	initializeFpu();
 	initializeSystemClock();
+	initializeKernelDataPage();
+	initializeAccounting();
 
 	//Init the virtual file system
 	fs_node_t* rootfs = get_vfs();
@@ -138,8 +145,7 @@ void initializeKernel(struct multiboot* mboot_ptr, uint32_t initial_esp) {
 	initializeKernelTerminal();
 	getTerminalInContext()->f_clear(getTerminalInContext());
 
-	//TODO: Move this into its own space
-	//Map the kernel stack
+	//Map the kernel stack the TSS starts out with, once processes are running each one has its own
 	for (MEM_LOC iterator = KERNEL_STACK_START - PAGE_SIZE; iterator >= KERNEL_STACK_START - KERNEL_STACK_SIZE; iterator -= PAGE_SIZE) {
 		MEM_LOC page = allocateFrame();
 		map(iterator, page, MEMORY_RESTRICTED_ACCESS);
@@ -147,6 +153,7 @@ void initializeKernel(struct multiboot* mboot_ptr, uint32_t initial_esp) {
 
 	kernelInitializeSyscallSystem();
 	kernelInitializeSyscalls();
+	initializeFutexes();
 	schedulerInitialize(initializeKernelProcess());
 	inputInitialize();
 	initializeSettingsManager();
@@ -12,9 +12,11 @@
 #include <panic/panic.h>
 #include <messages/messages.h>
 #include <scheduler/scheduler.h>
+#include <process/subscriptions.h>
 #include <fs/vfs.h>
 #include <system/system.h>
 #include <interrupts/interrupts.h>
+#include <smp/smp.h>
 
 //The kernel callback for a keyboard event
 //Registered with the kernel input manager in void post_init(); with a register_input_listener(DEVICE_KEYBOARD) call
@@ -30,8 +32,8 @@ void kernelInputCallback(uint32_t device, uint32_t main, void* additional) {
 	da.message_data[1] = main;
 	da.message_data[2] = *((MEM_LOC*) additional);
 
-	//Tell the scheduler to send the message to all processes with the INPUT_BIT flag set
-	schedulerGlobalMessage(da, INPUT_BIT);
+	//Send the message to all processes with the INPUT_BIT flag set
+	subscriptionsBroadcast(&da, INPUT_BIT);
 }
 
 void kernelMouseCallback(uint32_t device, uint32_t main, void* additional) {
@@ -53,8 +55,8 @@ void kernelMouseCallback(uint32_t device, uint32_t main, void* additional) {
 	printf("%i %i %i\n", message_data->i_byte, message_data->mouse_x,
 			message_data->mouse_y);
 
-	//Tell the scheduler to send the message to all processes with the INPUT_BIT flag set
-	schedulerGlobalMessage(da, INPUT_BIT);
+	//Send the message to all processes with the INPUT_BIT flag set
+	subscriptionsBroadcast(&da, INPUT_BIT);
 }
 
 int alive = 0;
@@ -71,5 +73,8 @@ void postInitialization() {
 	//Enable interrupts now
 	enableInterrupts();
 
+	//Bring up the other processors, this needs the clock running
+	initializeSmp();
+
 	systemProcess();
 }
@@ -2,6 +2,17 @@
 #define _CPU_DEFINITION_DEF_H_
 #include <common.h>
 
+/**
+ * Feature bits reported in EDX by cpuid leaf 1
+ */
+#define CPUID_FEATURE_FPU (1 << 0)
+#define CPUID_FEATURE_TSC (1 << 4)
+#define CPUID_FEATURE_MSR (1 << 5)
+#define CPUID_FEATURE_APIC (1 << 9)
+#define CPUID_FEATURE_SEP (1 << 11)
+#define CPUID_FEATURE_FXSR (1 << 24)
+#define CPUID_FEATURE_SSE (1 << 25)
+
 /**
  * Returns 1 if cpuid can be used to query CPU features, 0 otherwise
  */
@@ -17,4 +28,27 @@ const char* cpuidGetVendor();
  */
 unsigned long cpuidFeatures();
 
+/**
+ * Runs cpuid with the leaf given and stores the four result registers
+ */
+void cpuidQuery(unsigned long leaf, unsigned long* eax, unsigned long* ebx, unsigned long* ecx, unsigned long* edx);
+
+/**
+ * Returns 1 if cpuid leaf 1 reports the feature (One of the CPUID_FEATURE_ bits), 0 otherwise
+ */
+unsigned char cpuidHasFeature(unsigned long feature);
+
+/**
+ * Read / write a model specific register
+ */
+static inline uint64_t cpuReadMsr(uint32_t msr) {
+	uint32_t low, high;
+	__asm__ volatile("rdmsr" : "=a" (low), "=d" (high) : "c" (msr));
+	return ((uint64_t) high << 32) | low;
+}
+
+static inline void cpuWriteMsr(uint32_t msr, uint64_t value) {
+	__asm__ volatile("wrmsr" :: "c" (msr), "a" ((uint32_t) value), "d" ((uint32_t) (value >> 32)));
+}
+
 #endif //_CPU_DEFINITION_DEF_H_
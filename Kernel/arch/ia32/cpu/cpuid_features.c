@@ -19,3 +19,18 @@ unsigned long cpuidFeatures() {
 
 	return queryCpuidFeatures();
 }
+
+void cpuidQuery(unsigned long leaf, unsigned long* eax, unsigned long* ebx, unsigned long* ecx, unsigned long* edx) {
+	__asm__ volatile("cpuid" : "=a" (*eax), "=b" (*ebx), "=c" (*ecx), "=d" (*edx) : "a" (leaf), "c" (0));
+}
+
+unsigned char cpuidHasFeature(unsigned long feature) {
+	unsigned long eax, ebx, ecx, edx;
+
+	if (!cpuidSupported()) {
+		return 0;
+	}
+
+	cpuidQuery(0x1, &eax, &ebx, &ecx, &edx);
+	return (edx & feature) == feature;
+}
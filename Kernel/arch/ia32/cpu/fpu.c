@@ -0,0 +1,175 @@
+#include <cpu/fpu.h>
+#include <cpu/cpu.h>
+#include <cpu/percpu.h>
+#include <process/process.h>
+#include <scheduler/scheduler.h>
+#include <interrupts/interrupt_handler.h>
+#include <stdlib.h>
+#include <types/memory.h>
+
+#define FPU_NOT_AVAILABLE_INTERRUPT 7
+
+//The MXCSR value after reset, every SSE exception masked
+#define MXCSR_DEFAULT 0x1F80
+
+static unsigned char fxsrSupported = 0;
+static unsigned char sseSupported = 0;
+
+static inline uint32_t readCr0() {
+	uint32_t cr0;
+	__asm__ volatile("mov %%cr0, %0" : "=r" (cr0));
+	return cr0;
+}
+
+static inline void writeCr0(uint32_t cr0) {
+	__asm__ volatile("mov %0, %%cr0" :: "r" (cr0));
+}
+
+/**
+ * The saved state lives in a block from the kernel heap, aligned up for FXSAVE
+ */
+static inline void* fpuStateBuffer(process_t* process) {
+	return (void*) (((MEM_LOC) process->fpuState + FPU_STATE_ALIGN - 1) & ~(FPU_STATE_ALIGN - 1));
+}
+
+static void fpuSave(process_t* process) {
+	if (fxsrSupported) {
+		__asm__ volatile("fxsave (%0)" :: "r" (fpuStateBuffer(process)) : "memory");
+	} else {
+		__asm__ volatile("fnsave (%0); fwait" :: "r" (fpuStateBuffer(process)) : "memory");
+
+		//FSAVE reinitialises the FPU, so the registers no longer hold the state of anybody
+		getCpu()->fpuOwner = 0;
+	}
+}
+
+static void fpuRestore(process_t* process) {
+	if (fxsrSupported) {
+		__asm__ volatile("fxrstor (%0)" :: "r" (fpuStateBuffer(process)) : "memory");
+	} else {
+		__asm__ volatile("frstor (%0)" :: "r" (fpuStateBuffer(process)) : "memory");
+	}
+}
+
+static unsigned char fpuRegistersHeld(cpu_t* cpu, process_t* process) {
+	return cpu->fpuOwner == process && process->fpuCpu == cpu->id + 1;
+}
+
+/**
+ * The current process used the FPU for the first time this time slice
+ */
+static idt_call_registers_t fpuNotAvailable(idt_call_registers_t regs) {
+	cpu_t* cpu = getCpu();
+	process_t* process = getCurrentProcess();
+
+	__asm__ volatile("clts");
+
+	if (fpuRegistersHeld(cpu, process)) {
+		return regs;
+	}
+
+	if (process->fpuState) {
+		fpuRestore(process);
+	} else {
+		//First use, it starts out with a clean FPU
+		process->fpuState = malloc(FPU_STATE_SIZE + FPU_STATE_ALIGN);
+		memset(process->fpuState, 0, FPU_STATE_SIZE + FPU_STATE_ALIGN);
+
+		__asm__ volatile("fninit");
+
+		if (sseSupported) {
+			uint32_t mxcsr = MXCSR_DEFAULT;
+			__asm__ volatile("ldmxcsr %0" :: "m" (mxcsr));
+		}
+	}
+
+	cpu->fpuOwner = process;
+	process->fpuCpu = cpu->id + 1;
+	return regs;
+}
+
+void fpuInitializeCpu() {
+	uint32_t cr0 = readCr0();
+	cr0 &= ~CR0_EM;
+	cr0 |= CR0_MP | CR0_NE;
+	writeCr0(cr0);
+
+	__asm__ volatile("fninit");
+
+	if (fxsrSupported) {
+		uint32_t cr4;
+		__asm__ volatile("mov %%cr4, %0" : "=r" (cr4));
+
+		cr4 |= CR4_OSFXSR;
+
+		if (sseSupported) {
+			cr4 |= CR4_OSXMMEXCPT;
+		}
+
+		__asm__ volatile("mov %0, %%cr4" :: "r" (cr4));
+	}
+
+	//Nobody owns the FPU yet, the first process to use it traps
+	getCpu()->fpuOwner = 0;
+	writeCr0(readCr0() | CR0_TS);
+}
+
+void initializeFpu() {
+	fxsrSupported = cpuidHasFeature(CPUID_FEATURE_FXSR);
+	sseSupported = fxsrSupported && cpuidHasFeature(CPUID_FEATURE_SSE);
+
+	registerInterruptHandler(FPU_NOT_AVAILABLE_INTERRUPT, &fpuNotAvailable);
+	fpuInitializeCpu();
+}
+
+void fpuSwitch(process_t* from, process_t* to) {
+	cpu_t* cpu = getCpu();
+	uint32_t cr0 = readCr0();
+	uint32_t newCr0 = cr0;
+
+	//TS is only clear if from used the FPU this time slice. Its registers are saved now rather than when someone
+	//else wants the FPU, as from may be picked up by another CPU first
+	if (!(cr0 & CR0_TS) && from->fpuState) {
+		fpuSave(from);
+	}
+
+	if (fpuRegistersHeld(cpu, to)) {
+		newCr0 &= ~CR0_TS;
+	} else {
+		newCr0 |= CR0_TS;
+	}
+
+	if (newCr0 != cr0) {
+		writeCr0(newCr0);
+	}
+}
+
+void fpuForkState(process_t* parent, process_t* child) {
+	irq_flags_t flags = interruptsSave();
+
+	if (parent->fpuState) {
+
+		//Make sure the saved copy is up to date before it is copied
+		if (!(readCr0() & CR0_TS)) {
+			fpuSave(parent);
+
+			//FSAVE leaves the FPU reinitialised but the parent is still using it
+			if (!fxsrSupported) {
+				fpuRestore(parent);
+				getCpu()->fpuOwner = parent;
+			}
+		}
+
+		child->fpuState = malloc(FPU_STATE_SIZE + FPU_STATE_ALIGN);
+		memcpy(fpuStateBuffer(child), fpuStateBuffer(parent), FPU_STATE_SIZE);
+	}
+
+	interruptsRestore(flags);
+}
+
+void fpuFreeState(process_t* process) {
+	if (process->fpuState) {
+		free(process->fpuState);
+		process->fpuState = 0;
+	}
+}
@@ -0,0 +1,47 @@
+#ifndef _FPU_DEF_H_
+#define _FPU_DEF_H_
+#include <types/stdint.h>
+
+struct processStructure;
+
+#define CR0_MP (1 << 1)
+#define CR0_EM (1 << 2)
+#define CR0_TS (1 << 3)
+#define CR0_NE (1 << 5)
+
+#define CR4_OSFXSR (1 << 9)
+#define CR4_OSXMMEXCPT (1 << 10)
+
+/**
+ * The space FXSAVE needs (FSAVE needs less) and the alignment it requires
+ */
+#define FPU_STATE_SIZE 512
+#define FPU_STATE_ALIGN 16
+
+/**
+ * FPU and SSE state is switched lazily. CR0.TS is set when switching to a process so its first FPU instruction
+ * traps (#NM), and only then are its registers restored. A process that used the FPU during its time slice has its
+ * registers saved as it is switched away from, a process that never touches the FPU costs nothing.
+ *
+ * initializeFpu sets up the boot processor and the #NM handler, fpuInitializeCpu sets up every other CPU
+ */
+void initializeFpu();
+void fpuInitializeCpu();
+
+/**
+ * Called by switchProcess with interrupts disabled, saves the registers of from if it used them and sets CR0.TS
+ * unless this CPU still holds the registers of to
+ */
+void fpuSwitch(struct processStructure* from, struct processStructure* to);
+
+/**
+ * Give child a copy of the FPU state of parent (the current process), if it has any
+ */
+void fpuForkState(struct processStructure* parent, struct processStructure* child);
+
+/**
+ * Free the saved FPU state of a process that is no longer running
+ */
+void fpuFreeState(struct processStructure* process);
+
+#endif //_FPU_DEF_H_
@@ -0,0 +1,52 @@
+#include <cpu/percpu.h>
+#include <common.h>
+
+//The boot processor points at itself from the start so getCpu() works as soon as the GDT is loaded
+static cpu_t cpus[MAX_CPUS] = { { .self = &cpus[0] } };
+static unsigned int numCpus = 1;
+
+cpu_t* cpuBootProcessor() {
+	return &cpus[0];
+}
+
+cpu_t* cpuGet(unsigned int id) {
+
+	if (id >= numCpus) {
+		return 0;
+	}
+
+	return &cpus[id];
+}
+
+unsigned int cpuCount() {
+	return numCpus;
+}
+
+cpu_t* cpuRegister(unsigned int apicId) {
+
+	if (numCpus == MAX_CPUS) {
+		return 0;
+	}
+
+	cpu_t* cpu = &cpus[numCpus];
+	memset(cpu, 0, sizeof(cpu_t));
+	cpu->self = cpu;
+	cpu->id = numCpus;
+	cpu->apicId = apicId;
+
+	numCpus++;
+	return cpu;
+}
+
+void cpuInitialize(cpu_t* cpu) {
+	cpu->self = cpu;
+
+	//Start from the boot GDT and point the per-CPU segment at this CPU
+	memcpy(cpu->gdt, gdt_entries, sizeof(gdt_entry_t) * NUM_GDT_ENTRIES);
+	gdtSetEntry(cpu->gdt, GDT_PERCPU_ENTRY, (uint32_t) cpu, sizeof(cpu_t) - 1, 0x92, 0x40);
+
+	cpu->gdtPtr.limit = (sizeof(gdt_entry_t) * NUM_GDT_ENTRIES) - 1;
+	cpu->gdtPtr.base = (uint32_t) cpu->gdt;
+
+	initializeTss(cpu);
+}
@@ -0,0 +1,159 @@
+#ifndef _PER_CPU_DATA_DEF_H_
+#define _PER_CPU_DATA_DEF_H_
+#include <types/stdint.h>
+#include <mm/gdt.h>
+#include <tss/tss.h>
+
+#define MAX_CPUS 8
+
+#ifndef _SWITCH_STATS_
+#define _SWITCH_STATS_ 0
+#endif
+
+struct process_entry_t;
+struct processStructure;
+
+/**
+ * The data owned by a single CPU. Each CPU has its own GDT in which the per-CPU data segment
+ * (GDT_PERCPU_SELECTOR) is based at its cpu_t and gs is loaded with that selector while in the kernel,
+ * so getCpu() can find the structure of whichever CPU is running the code without locking
+ */
+typedef struct cpuStructure {
+
+	/**
+	 * Points back at this structure, it must be the first field so it can be read from gs:0
+	 */
+	struct cpuStructure* self;
+
+	/**
+	 * The logical ID of the CPU (0 is always the boot processor) and the ID of its local APIC
+	 */
+	unsigned int id;
+	unsigned int apicId;
+
+	/**
+	 * Set by the CPU itself once it has finished starting up
+	 */
+	volatile unsigned char online;
+
+	/**
+	 * The circular run queue of this CPU, the entry currently executing on it and the number of entries in the queue
+	 */
+	struct process_entry_t* runQueue;
+	struct process_entry_t* current;
+	unsigned int runQueueLength;
+
+	/**
+	 * The process of the current entry, kept in step with it by the scheduler so getCurrentProcess() is a single read
+	 * through gs
+	 */
+	struct processStructure* currentProcess;
+
+	/**
+	 * The entry run when nothing else on this CPU can, it is never moved to another CPU
+	 */
+	struct process_entry_t* idle;
+
+	/**
+	 * Set while the CPU is halted because nothing can run
+	 */
+	volatile unsigned char idling;
+
+	/**
+	 * Set once the scheduler can place processes on this CPU
+	 */
+	volatile unsigned char schedulerActive;
+
+	/**
+	 * While non zero the scheduler won't preempt the process running on this CPU (incremented for every spinlock held)
+	 */
+	volatile unsigned int preemptCount;
+
+	/**
+	 * Set when the time slice of the current process ran out while it couldn't be preempted, it is switched away
+	 * from at its next preemption point
+	 */
+	volatile unsigned char needResched;
+
+	/**
+	 * The process whose state was last loaded into the FPU of this CPU
+	 */
+	struct processStructure* fpuOwner;
+
+	/**
+	 * The TSC at the last point the process running on this CPU was charged for its time
+	 */
+	uint64_t accountingTsc;
+
+#if _SWITCH_STATS_
+	/**
+	 * Built with SWITCH_STATS=1 every switch back into a process that has run before is timed, from just before
+	 * switch_to in the process leaving to just after it in the process resuming. The counts and cycles are split by
+	 * whether cr3 had to be reloaded (index 1) or the page directory was shared (index 0)
+	 */
+	uint64_t switchStartTsc;
+	unsigned char switchReloadsCr3;
+	unsigned long switchCount[2];
+	uint64_t switchCycles[2];
+#endif
+
+	/**
+	 * The GDT and TSS of this CPU
+	 */
+	gdt_entry_t gdt[NUM_GDT_ENTRIES];
+	gdt_ptr_t gdtPtr;
+	tss_entry_t tss;
+} cpu_t;
+
+/**
+ * The offset of a field in cpu_t, for reading it through gs in a single instruction
+ */
+#define PERCPU_OFFSET(field) __builtin_offsetof(cpu_t, field)
+
+/**
+ * Returns the structure of the CPU executing the call. Unless preemption is disabled the caller may be moved to
+ * another CPU as soon as this returns
+ */
+static inline cpu_t* getCpu() {
+	cpu_t* cpu;
+	__asm__ volatile("mov %%gs:0, %0" : "=r" (cpu));
+	return cpu;
+}
+
+/**
+ * Read the pointer sized field of the current CPUs structure in one instruction, so the value comes from the CPU
+ * the caller is running on even if it is preempted and moved right after
+ */
+#define PERCPU_READ(field) ({ \
+	__typeof__(((cpu_t*) 0)->field) value; \
+	__asm__ volatile("mov %%gs:%c1, %0" : "=r" (value) : "i" (PERCPU_OFFSET(field))); \
+	value; \
+})
+
+/**
+ * Returns the structure of the boot processor
+ */
+cpu_t* cpuBootProcessor();
+
+/**
+ * Returns the structure of the CPU with the logical ID given, or 0 if there is no such CPU
+ */
+cpu_t* cpuGet(unsigned int id);
+
+/**
+ * Returns the number of CPUs that have been registered
+ */
+unsigned int cpuCount();
+
+/**
+ * Register a CPU found in the MP or ACPI tables and return its structure (0 if there are too many)
+ */
+cpu_t* cpuRegister(unsigned int apicId);
+
+/**
+ * Build the GDT and TSS for the CPU given and load them on the CPU executing the call. After this
+ * getCpu() on the calling CPU returns cpu
+ */
+void cpuInitialize(cpu_t* cpu);
+
+#endif //_PER_CPU_DATA_DEF_H_
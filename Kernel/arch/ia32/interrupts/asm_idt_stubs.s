@@ -13,8 +13,8 @@ irq_common_stub:
 
    mov ax, 0x10  ; load the kernel data segment descriptor
    mov ds, ax
-   mov es, ax
-   mov fs, ax
+   mov es, ax    ; fs is left alone, it holds the TLS segment of the process and the kernel never uses it
+   mov ax, 0x30  ; load the per-CPU data segment
    mov gs, ax
 
    call irq_handler
@@ -22,8 +22,10 @@ irq_common_stub:
    pop ebx        ; reload the original data segment descriptor
    mov ds, bx
    mov es, bx
-   mov fs, bx
+   test byte [esp+44], 3 ; gs only changes when returning to user mode, in the kernel it stays on the per-CPU data
+   jz .kernel_gs
    mov gs, bx
+.kernel_gs:
 
    popa                     ; Pops edi,esi,ebp...
    add esp, 8     ; Cleans up the pushed error code and pushed ISR number
@@ -46,8 +48,8 @@ isr_common_stub:
 
     mov ax, 0x10  ; load the kernel data segment descriptor
     mov ds, ax
-    mov es, ax
-    mov fs, ax
+    mov es, ax    ; fs is left alone, it holds the TLS segment of the process and the kernel never uses it
+    mov ax, 0x30  ; load the per-CPU data segment
     mov gs, ax
 
     call isr_handler
@@ -55,8 +57,10 @@ isr_common_stub:
     pop ebx        ; reload the original data segment descriptor
     mov ds, bx
     mov es, bx
-    mov fs, bx
+    test byte [esp+44], 3 ; gs only changes when returning to user mode, in the kernel it stays on the per-CPU data
+    jz .kernel_gs
     mov gs, bx
+.kernel_gs:
 
     popa                     ; Pops edi,esi,ebp...
     add esp, 8     ; Cleans up the pushed error code and pushed ISR number
@@ -58,7 +58,9 @@ void Initialize_IDT()
 	idt_set_gate( 29, (uint32_t)isr29 , 0x08, 0x8E);
 	idt_set_gate( 30, (uint32_t)isr30 , 0x08, 0x8E);
 	idt_set_gate( 31, (uint32_t)isr31 , 0x08, 0x8E);
-	idt_set_gate( 127, (uint32_t)isr127 , 0x08, 0x8E);
+
+	//Syscalls go through a trap gate so interrupts stay enabled and a long syscall can be preempted
+	idt_set_gate( 127, (uint32_t)isr127 , 0x08, 0x8F);
 
 	//Set the irq handlers up.
   	idt_set_gate(32, (uint32_t)irq0, 0x08, 0x8E);
@@ -77,6 +79,7 @@ void Initialize_IDT()
   	idt_set_gate(45, (uint32_t)irq13, 0x08, 0x8E);
   	idt_set_gate(46, (uint32_t)irq14, 0x08, 0x8E);
   	idt_set_gate(47, (uint32_t)irq15, 0x08, 0x8E);
+  	idt_set_gate(48, (uint32_t)irq16, 0x08, 0x8E);
 
 	idt_flush((uint32_t) &idt_ptr);
 }
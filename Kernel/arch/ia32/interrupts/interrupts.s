@@ -80,3 +80,4 @@ IRQ 12, 44
 IRQ 13, 45
 IRQ 14, 46
 IRQ 15, 47
+IRQ 16, 48 ; Local APIC timer
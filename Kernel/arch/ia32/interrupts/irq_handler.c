@@ -1,20 +1,29 @@
 #include <interrupts/idt.h>
 #include <interrupts/interrupt_handler.h>
 #include <printf.h>
+#include <smp/lapic.h>
 
 extern isr_t interrupt_handlers[256];
 
 void irq_handler(idt_call_registers_t regs)
 {
-   // Send an EOI (end of interrupt) signal to the PICs.
-   // If this interrupt involved the slave.
-   if (regs.int_no >= 40)
+   // Interrupts from the local APIC are acknowledged there, not at the PICs
+   if (regs.int_no >= LAPIC_TIMER_VECTOR)
    {
-       // Send reset signal to slave.
-       outb(0xA0, 0x20);
+       lapicEndOfInterrupt();
+   }
+   else
+   {
+       // Send an EOI (end of interrupt) signal to the PICs.
+       // If this interrupt involved the slave.
+       if (regs.int_no >= 40)
+       {
+           // Send reset signal to slave.
+           outb(0xA0, 0x20);
+       }
+       // Send reset signal to master. (As well as slave, if necessary).
+       outb(0x20, 0x20);
    }
-   // Send reset signal to master. (As well as slave, if necessary).
-   outb(0x20, 0x20);
 
    if (interrupt_handlers[regs.int_no] != 0)
    {
@@ -2,6 +2,7 @@
 #include <loaders/executable_parser.h>
 
 #include <mm/virtual.h>
+#include <mm/virt_mm.h>
 #include <mm/phys_mm.h>
 #include <types/stdint.h>
 #include <types/memory.h>
@@ -10,22 +11,34 @@
 #include <usermode/usermode.h>
 #include <scheduler/scheduler.h>
 #include <fs/vfs.h>
+#include <lock/spinlock.h>
+#include <lock/atomic.h>
 
 typedef int (*entry_point)(int argc, void* argv);
 
+//The most recently launched images, most recent first
+static executable_image_t* imageCache[EXECUTABLE_CACHE_SIZE];
+static spinlock_t imageCacheLock = SPINLOCK_INIT("executable cache");
+
 unsigned char mapMemoryUsingHeader(e32_pheader program_header) {
 
 	//If the program header is a loadable object, map it into memory
 	if (program_header.p_type == PT_LOAD) {
 
-		MEM_LOC v_addr_start = program_header.p_vaddr;
-		MEM_LOC v_addr_end = v_addr_start + program_header.p_memsz;
+		MEM_LOC v_addr_start = program_header.p_vaddr & PAGE_MASK;
+		MEM_LOC v_addr_end = program_header.p_vaddr + program_header.p_memsz;
 
 		MEM_LOC iterator = v_addr_start;
 
 		while (iterator < v_addr_end) {
-			map(iterator, allocateFrameForProcess(getCurrentProcess()), 0);
+
+			//Segments can share a page
+			if (!getMapping(iterator, 0)) {
+				map(iterator, allocateFrameForProcess(getCurrentProcess()), 0);
+			}
+
 			iterator += PAGE_SIZE;
+			schedulerPreemptionPoint();
 		}
 	} else {
 	}
@@ -42,22 +55,23 @@ unsigned char loadToMemoryUsingHeader(e32_pheader program_header,
 			DEBUG_PRINT("Error bad read\n");
 			return 0;
 		}
+
+		//Frames are not cleared when they are freed so the rest of the segment (the bss) is zeroed here
+		memset((void*) (program_header.p_vaddr + program_header.p_filesz), 0,
+				program_header.p_memsz - program_header.p_filesz);
 	}
 
 	return 1;
 }
 
-int loadAndExecuteProgram(fs_node_t* Node, unsigned char usermode) {
-	DEBUG_PRINT("Loading program\n");
-
-	//Read the ELF info
-	e32info* fileInfo = malloc(sizeof(e32info));
-	memset(fileInfo, 0, sizeof(e32info));
-
-	parseElfFile(fileInfo, Node);
+/**
+ * Validate and read the headers of the file given
+ */
+static int parseImage(fs_node_t* node, executable_image_t** image) {
 
-	//Use the header from the parsed file
-	e32_header head = fileInfo->m_mainHeader;
+	//Anything that changes the file after this is caught by the version
+	uint32_t version = node->version;
+	e32_header head = parseElfHeader(node);
 
 	//Is it a executable?
 	if (head.e_type != ELF_EXE) {
@@ -84,34 +98,162 @@ int loadAndExecuteProgram(fs_node_t* Node, unsigned char usermode) {
 		return LOAD_ERROR_BAD_PLATFORM;
 	}
 
+	if (head.e_phentsize != sizeof(e32_pheader)) {
+		return LOAD_ERROR_BAD_HEAD;
+	}
+
+	//Read every program header at once, only the loadable ones are kept
+	unsigned int size = head.e_phnum * sizeof(e32_pheader);
+	e32_pheader* headers = malloc(size);
+
+	if (read_fs(node, head.e_phoff, size, (uint8_t*) headers) != size) {
+		free(headers);
+		return LOAD_ERROR_BAD_HEAD;
+	}
+
+	executable_image_t* result = malloc(sizeof(executable_image_t));
+	result->node = node;
+	result->version = version;
+	result->length = node->length;
+	result->references = 1;
+	result->entry = head.e_entry;
+	result->numSegments = 0;
+	result->segments = headers;
+
+	for (unsigned int i = 0; i < head.e_phnum; i++) {
+		if (headers[i].p_type == PT_LOAD) {
+
+			if (headers[i].p_filesz > headers[i].p_memsz
+					|| headers[i].p_vaddr + headers[i].p_memsz > KERNEL_START) {
+				executableImageRelease(result);
+				return LOAD_ERROR_BAD_HEAD;
+			}
+
+			headers[result->numSegments++] = headers[i];
+		}
+	}
+
 	DEBUG_PRINT("Headers valid\n");
 
-	//This segment of code correlates to the loading of the data into virtual memory
+	*image = result;
+	return 0;
+}
+
+/**
+ * Move the entry at index to the front of the cache and put image in it. imageCacheLock must be held
+ */
+static void cacheMoveToFront(unsigned int index, executable_image_t* image) {
+
+	for (unsigned int i = index; i > 0; i--) {
+		imageCache[i] = imageCache[i - 1];
+	}
+
+	imageCache[0] = image;
+}
+
+int executableImageParse(fs_node_t* node, executable_image_t** image) {
+	executable_image_t* stale = 0;
+
+	spinlockAcquire(&imageCacheLock);
+
+	for (unsigned int i = 0; i < EXECUTABLE_CACHE_SIZE && imageCache[i]; i++) {
+		executable_image_t* cached = imageCache[i];
+
+		if (cached->node != node) {
+			continue;
+		}
+
+		if (cached->version == node->version && cached->length == node->length) {
+			atomicFetchAdd(&cached->references, 1);
+			cacheMoveToFront(i, cached);
+			spinlockRelease(&imageCacheLock);
+
+			*image = cached;
+			return 0;
+		}
+
+		//The file has changed since it was parsed, drop it from the cache
+		stale = cached;
+
+		for (; i + 1 < EXECUTABLE_CACHE_SIZE; i++) {
+			imageCache[i] = imageCache[i + 1];
+		}
+
+		imageCache[EXECUTABLE_CACHE_SIZE - 1] = 0;
+		break;
+	}
+
+	spinlockRelease(&imageCacheLock);
+
+	if (stale) {
+		executableImageRelease(stale);
+	}
+
+	//The file is read without the lock held, so another launch of it may have cached it by the time its done
+	int error = parseImage(node, image);
+
+	if (error) {
+		return error;
+	}
+
+	atomicFetchAdd(&(*image)->references, 1);
+
+	spinlockAcquire(&imageCacheLock);
+
+	unsigned int index = EXECUTABLE_CACHE_SIZE - 1;
+
+	for (unsigned int i = 0; i < EXECUTABLE_CACHE_SIZE; i++) {
+		if (!imageCache[i] || imageCache[i]->node == node) {
+			index = i;
+			break;
+		}
+	}
+
+	executable_image_t* evicted = imageCache[index];
+	cacheMoveToFront(index, *image);
+
+	spinlockRelease(&imageCacheLock);
+
+	if (evicted) {
+		executableImageRelease(evicted);
+	}
+
+	return 0;
+}
+
+int executableImageLoad(executable_image_t* image) {
 
-	//Iterate through every program header
-	for (unsigned int header_iter = 0; header_iter < fileInfo->m_numProgramHeaders; ++header_iter) {
-		e32_pheader program_header = fileInfo->m_programHeaders[header_iter];
-		if (mapMemoryUsingHeader(program_header) != 1) {
-			DEBUG_PRINT("Error mapping program header %i\n", header_iter);
+	//Map every segment first, then load them
+	for (unsigned int i = 0; i < image->numSegments; i++) {
+		if (mapMemoryUsingHeader(image->segments[i]) != 1) {
+			DEBUG_PRINT("Error mapping program header %i\n", i);
 			return LOAD_ERROR_BAD_MAP;
 		}
 	}
 
-	//Load the object blocks that where just mapped
-	for (unsigned int header_iter = 0; header_iter < fileInfo->m_numProgramHeaders; ++header_iter) {
-		e32_pheader program_header = fileInfo->m_programHeaders[header_iter];
-		if (loadToMemoryUsingHeader(program_header, Node) != 1) {
-			DEBUG_PRINT("Error unable to load header %i\n", header_iter);
+	for (unsigned int i = 0; i < image->numSegments; i++) {
+		if (loadToMemoryUsingHeader(image->segments[i], image->node) != 1) {
+			DEBUG_PRINT("Error unable to load header %i\n", i);
 			return LOAD_ERROR_BAD_LOAD;
 		}
 	}
 
-	//This segment of code correlates to its execution
-	entry_point program_entry_ponter = (entry_point) head.e_entry;
+	return 0;
+}
+
+void executableImageRelease(executable_image_t* image) {
+
+	if (atomicFetchAdd(&image->references, -1) != 1) {
+		return;
+	}
+
+	free(image->segments);
+	free(image);
+}
 
-	//This free's up the ELF info and then deletes the structure from the heap
-	freeElfFileInfo(fileInfo);
-	free(fileInfo);
+void executableImageExecute(executable_image_t* image, unsigned char usermode) {
+	entry_point program_entry_ponter = (entry_point) image->entry;
+	executableImageRelease(image);
 
 	if (usermode == 1) {
 		switchToUserMode();
@@ -120,5 +262,25 @@ int loadAndExecuteProgram(fs_node_t* Node, unsigned char usermode) {
 	program_entry_ponter(0, 0);
 	schedulerKillCurrentProcess();
 	PANIC("I should never get here");
+}
+
+int loadAndExecuteProgram(fs_node_t* Node, unsigned char usermode) {
+	DEBUG_PRINT("Loading program\n");
+
+	executable_image_t* image;
+	int error = executableImageParse(Node, &image);
+
+	if (error) {
+		return error;
+	}
+
+	error = executableImageLoad(image);
+
+	if (error) {
+		executableImageRelease(image);
+		return error;
+	}
+
+	executableImageExecute(image, usermode);
 	return 0;
 }
@@ -0,0 +1,61 @@
+#ifndef _IA32_ATOMIC_DEF_H_
+#define _IA32_ATOMIC_DEF_H_
+#include <types/stdint.h>
+
+/**
+ * Atomically add value to *target and return what *target held before the add
+ */
+static inline uint32_t atomicFetchAdd(volatile uint32_t* target, uint32_t value) {
+	__asm__ volatile("lock; xaddl %0, %1" : "+r" (value), "+m" (*target) : : "memory");
+	return value;
+}
+
+/**
+ * Atomically set *target to replacement if it currently holds expected. Returns what *target held
+ * before the operation, so the exchange happened if the return value equals expected
+ */
+static inline uint32_t atomicCompareExchange(volatile uint32_t* target, uint32_t expected, uint32_t replacement) {
+	uint32_t previous;
+	__asm__ volatile("lock; cmpxchgl %2, %1" : "=a" (previous), "+m" (*target) : "r" (replacement), "0" (expected) : "memory");
+	return previous;
+}
+
+/**
+ * Atomically store value in *target and return the old value
+ */
+static inline uint32_t atomicExchange(volatile uint32_t* target, uint32_t value) {
+	__asm__ volatile("xchgl %0, %1" : "+r" (value), "+m" (*target) : : "memory");
+	return value;
+}
+
+/**
+ * Stop the compiler moving memory accesses across this point
+ */
+#define compilerBarrier() __asm__ volatile("" : : : "memory")
+
+/**
+ * Hint to the CPU that it is spinning on a lock
+ */
+#define cpuRelax() __asm__ volatile("pause" : : : "memory")
+
+/**
+ * Read the time stamp counter
+ */
+static inline uint64_t readTimestampCounter() {
+	uint32_t low, high;
+	__asm__ volatile("rdtsc" : "=a" (low), "=d" (high));
+	return ((uint64_t) high << 32) | low;
+}
+
+/**
+ * Divide a cycle count by a 32 bit value without needing libgcc's 64 bit division. The result has to fit in 32 bits,
+ * which it does for the averages this is used for
+ */
+static inline uint32_t cyclesDivide(uint64_t cycles, uint32_t divisor) {
+	uint32_t quotient, remainder;
+	__asm__("divl %4" : "=a" (quotient), "=d" (remainder) : "a" ((uint32_t) cycles), "d" ((uint32_t) (cycles >> 32)),
+			"rm" (divisor));
+	return quotient;
+}
+
+#endif //_IA32_ATOMIC_DEF_H_
@@ -0,0 +1,62 @@
+#include <lock/rwlock.h>
+
+void rwlockInit(rwlock_t* lock, const char* name) {
+	lock->state = 0;
+	lock->writersWaiting = 0;
+
+#if _LOCK_DEBUG_
+	lock->name = name;
+	lock->readContentions = 0;
+	lock->writeContentions = 0;
+#endif
+}
+
+void rwlockReadAcquire(rwlock_t* lock) {
+	preemptDisable();
+
+	for (;;) {
+		uint32_t state = lock->state;
+
+		if (state != RWLOCK_WRITER && !lock->writersWaiting
+				&& atomicCompareExchange(&lock->state, state, state + 1) == state) {
+			break;
+		}
+
+#if _LOCK_DEBUG_
+		lock->readContentions++;
+#endif
+
+		cpuRelax();
+	}
+
+	compilerBarrier();
+}
+
+void rwlockReadRelease(rwlock_t* lock) {
+	compilerBarrier();
+	atomicFetchAdd(&lock->state, (uint32_t) -1);
+	preemptEnable();
+}
+
+void rwlockWriteAcquire(rwlock_t* lock) {
+	preemptDisable();
+	atomicFetchAdd(&lock->writersWaiting, 1);
+
+	while (atomicCompareExchange(&lock->state, 0, RWLOCK_WRITER) != 0) {
+
+#if _LOCK_DEBUG_
+		lock->writeContentions++;
+#endif
+
+		cpuRelax();
+	}
+
+	atomicFetchAdd(&lock->writersWaiting, (uint32_t) -1);
+	compilerBarrier();
+}
+
+void rwlockWriteRelease(rwlock_t* lock) {
+	compilerBarrier();
+	atomicExchange(&lock->state, 0);
+	preemptEnable();
+}
@@ -0,0 +1,40 @@
+#ifndef _READER_WRITER_LOCK_DEF_H_
+#define _READER_WRITER_LOCK_DEF_H_
+#include <lock/spinlock.h>
+
+/**
+ * A spinning reader-writer lock. Any number of readers can hold it at once, a writer holds it alone.
+ * Once a writer is waiting new readers hold back so a steady stream of readers can't starve it
+ */
+typedef struct {
+
+	/**
+	 * The number of readers holding the lock, or RWLOCK_WRITER when a writer holds it
+	 */
+	volatile uint32_t state;
+	volatile uint32_t writersWaiting;
+
+#if _LOCK_DEBUG_
+	const char* name;
+	unsigned long readContentions;
+	unsigned long writeContentions;
+#endif
+} rwlock_t;
+
+#define RWLOCK_WRITER 0xFFFFFFFF
+
+#if _LOCK_DEBUG_
+#define RWLOCK_INIT(lockName) { 0, 0, lockName, 0, 0 }
+#else
+#define RWLOCK_INIT(lockName) { 0, 0 }
+#endif
+
+void rwlockInit(rwlock_t* lock, const char* name);
+
+void rwlockReadAcquire(rwlock_t* lock);
+void rwlockReadRelease(rwlock_t* lock);
+
+void rwlockWriteAcquire(rwlock_t* lock);
+void rwlockWriteRelease(rwlock_t* lock);
+
+#endif //_READER_WRITER_LOCK_DEF_H_
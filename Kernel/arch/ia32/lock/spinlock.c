@@ -0,0 +1,163 @@
+#include <lock/spinlock.h>
+#include <cpu/percpu.h>
+#include <panic/panic.h>
+#include <printf.h>
+
+#if _LOCK_DEBUG_
+//Every lock that has been taken at least once, so spinlockDebugReport can find them. Managed with raw tickets
+//since the registry lock can't record statistics about itself
+static spinlock_t debugRegistryLock = SPINLOCK_INIT("lock registry");
+static spinlock_t* debugRegistry = 0;
+#endif
+
+irq_flags_t interruptsSave() {
+	irq_flags_t flags;
+	__asm__ volatile("pushf; pop %0; cli" : "=r" (flags) : : "memory");
+	return flags;
+}
+
+void interruptsRestore(irq_flags_t flags) {
+	__asm__ volatile("push %0; popf" : : "r" (flags) : "memory", "cc");
+}
+
+void preemptDisable() {
+	__asm__ volatile("incl %%gs:%c0" : : "i" (PERCPU_OFFSET(preemptCount)) : "memory");
+}
+
+void preemptEnable() {
+	__asm__ volatile("decl %%gs:%c0" : : "i" (PERCPU_OFFSET(preemptCount)) : "memory");
+}
+
+void spinlockInit(spinlock_t* lock, const char* name) {
+	lock->nextTicket = 0;
+	lock->ownerTicket = 0;
+
+#if _LOCK_DEBUG_
+	lock->name = name;
+	lock->acquisitions = 0;
+	lock->contentions = 0;
+	lock->acquiredAt = 0;
+	lock->totalHoldCycles = 0;
+	lock->maxHoldCycles = 0;
+	lock->holderCpu = -1;
+	lock->debugRegistered = 0;
+	lock->debugNext = 0;
+#endif
+}
+
+/**
+ * Take a ticket and spin untill it is served, returns 1 if the lock was not free straight away
+ */
+static unsigned char ticketAcquire(spinlock_t* lock) {
+	uint32_t ticket = atomicFetchAdd(&lock->nextTicket, 1);
+	unsigned char contended = 0;
+
+	while (lock->ownerTicket != ticket) {
+		contended = 1;
+		cpuRelax();
+	}
+
+	compilerBarrier();
+	return contended;
+}
+
+static void ticketRelease(spinlock_t* lock) {
+	compilerBarrier();
+	lock->ownerTicket++;
+}
+
+#if _LOCK_DEBUG_
+static void debugAcquired(spinlock_t* lock, unsigned char contended) {
+	lock->acquisitions++;
+	lock->contentions += contended;
+	lock->holderCpu = getCpu()->id;
+	lock->acquiredAt = readTimestampCounter();
+
+	if (!lock->debugRegistered) {
+		lock->debugRegistered = 1;
+		ticketAcquire(&debugRegistryLock);
+		lock->debugNext = debugRegistry;
+		debugRegistry = lock;
+		ticketRelease(&debugRegistryLock);
+	}
+}
+
+static void debugReleasing(spinlock_t* lock) {
+	uint64_t held = readTimestampCounter() - lock->acquiredAt;
+	lock->totalHoldCycles += held;
+
+	if (held > lock->maxHoldCycles) {
+		lock->maxHoldCycles = held;
+	}
+
+	lock->holderCpu = -1;
+}
+#endif
+
+void spinlockAcquire(spinlock_t* lock) {
+	preemptDisable();
+
+#if _LOCK_DEBUG_
+	if (lock->holderCpu == (int) getCpu()->id && lock->ownerTicket != lock->nextTicket) {
+		PANIC("Spinlock taken twice by the same CPU\n");
+	}
+
+	debugAcquired(lock, ticketAcquire(lock));
+#else
+	ticketAcquire(lock);
+#endif
+}
+
+unsigned char spinlockTryAcquire(spinlock_t* lock) {
+	preemptDisable();
+
+	uint32_t ticket = lock->ownerTicket;
+
+	//Only take a ticket if it would be served straight away
+	if (atomicCompareExchange(&lock->nextTicket, ticket, ticket + 1) != ticket) {
+		preemptEnable();
+		return 0;
+	}
+
+	compilerBarrier();
+
+#if _LOCK_DEBUG_
+	debugAcquired(lock, 0);
+#endif
+
+	return 1;
+}
+
+void spinlockRelease(spinlock_t* lock) {
+
+#if _LOCK_DEBUG_
+	debugReleasing(lock);
+#endif
+
+	ticketRelease(lock);
+	preemptEnable();
+}
+
+irq_flags_t spinlockAcquireIrqSave(spinlock_t* lock) {
+	irq_flags_t flags = interruptsSave();
+	spinlockAcquire(lock);
+	return flags;
+}
+
+void spinlockReleaseIrqRestore(spinlock_t* lock, irq_flags_t flags) {
+	spinlockRelease(lock);
+	interruptsRestore(flags);
+}
+
+void spinlockDebugReport() {
+
+#if _LOCK_DEBUG_
+	printf("Lock statistics (name, acquisitions, contended, max hold cycles, average hold cycles)\n");
+
+	for (spinlock_t* iter = debugRegistry; iter; iter = iter->debugNext) {
+		unsigned long average = iter->acquisitions ? cyclesDivide(iter->totalHoldCycles, iter->acquisitions) : 0;
+		printf("%s %i %i %i %i\n", iter->name ? iter->name : "unnamed", iter->acquisitions, iter->contentions,
+				(unsigned long) iter->maxHoldCycles, average);
+	}
+#endif
+}
@@ -0,0 +1,84 @@
+#ifndef _SPINLOCK_DEF_H_
+#define _SPINLOCK_DEF_H_
+#include <types/stdint.h>
+#include <lock/atomic.h>
+
+#ifndef _LOCK_DEBUG_
+#define _LOCK_DEBUG_ 0
+#endif
+
+/**
+ * A ticket spinlock. Each CPU wanting the lock takes the next ticket and spins untill ownerTicket reaches it,
+ * so CPUs get the lock in the order they asked for it.
+ *
+ * Holding a spinlock disables preemption on the CPU (the scheduler will not switch away from the holder on a
+ * clock tick) but leaves interrupts alone. Locks that are also taken from interrupt handlers must use the
+ * IrqSave variants, which disable interrupts for as long as the lock is held
+ */
+typedef struct spinlockStructure {
+	volatile uint32_t nextTicket;
+	volatile uint32_t ownerTicket;
+
+#if _LOCK_DEBUG_
+	/**
+	 * Built with LOCK_DEBUG=1 every lock records how often it was taken, how often the taker had to spin and
+	 * how long (in TSC cycles) it was held for
+	 */
+	const char* name;
+	unsigned long acquisitions;
+	unsigned long contentions;
+	uint64_t acquiredAt;
+	uint64_t totalHoldCycles;
+	uint64_t maxHoldCycles;
+	int holderCpu;
+	unsigned char debugRegistered;
+	struct spinlockStructure* debugNext;
+#endif
+} spinlock_t;
+
+#if _LOCK_DEBUG_
+#define SPINLOCK_INIT(lockName) { 0, 0, lockName, 0, 0, 0, 0, 0, -1, 0, 0 }
+#else
+#define SPINLOCK_INIT(lockName) { 0, 0 }
+#endif
+
+/**
+ * The interrupt flag state saved by the IrqSave variants
+ */
+typedef unsigned long irq_flags_t;
+
+void spinlockInit(spinlock_t* lock, const char* name);
+
+void spinlockAcquire(spinlock_t* lock);
+void spinlockRelease(spinlock_t* lock);
+
+/**
+ * Take the lock only if nobody holds it, returns 1 if the lock was taken
+ */
+unsigned char spinlockTryAcquire(spinlock_t* lock);
+
+/**
+ * Disable interrupts on this CPU and take the lock, returning the previous interrupt state to be handed back to
+ * spinlockReleaseIrqRestore
+ */
+irq_flags_t spinlockAcquireIrqSave(spinlock_t* lock);
+void spinlockReleaseIrqRestore(spinlock_t* lock, irq_flags_t flags);
+
+/**
+ * Disable interrupts returning the previous state / put back a state returned by interruptsSave
+ */
+irq_flags_t interruptsSave();
+void interruptsRestore(irq_flags_t flags);
+
+/**
+ * Stop / allow the scheduler preempting the current process on a clock tick. Calls nest
+ */
+void preemptDisable();
+void preemptEnable();
+
+/**
+ * Print the statistics of every lock that has been taken (only does anything when built with LOCK_DEBUG=1)
+ */
+void spinlockDebugReport();
+
+#endif //_SPINLOCK_DEF_H_
@@ -1,10 +1,9 @@
 #include <mm/gdt.h>
+#include <cpu/percpu.h>
 
-#define NUM_GDT_ENTRIES 6
 gdt_entry_t gdt_entries[NUM_GDT_ENTRIES];
 gdt_ptr_t   gdt_ptr;
 
-void gdtSetGate(unsigned int, uint32_t, uint32_t, uint8_t, uint8_t);
 extern void gdt_flush(uint32_t);
 
 void initializeGdt() {
@@ -19,6 +18,12 @@ void initializeGdt() {
    gdtSetGate(3, 0, 0xFFFFFFFF, 0xFA, 0xCF); // User mode code segment (Present, ring3, Executable)
    gdtSetGate(4, 0, 0xFFFFFFFF, 0xF2, 0xCF); // User mode data segment (Present, ring3)
 
+   // Per-CPU data segment (Present, ring0, byte granular), the boot processor until the other CPUs have their own GDTs
+   gdtSetGate(GDT_PERCPU_ENTRY, (uint32_t) cpuBootProcessor(), sizeof(cpu_t) - 1, 0x92, 0x40);
+
+   // Thread local storage segment (Present, ring3), rebased on every context switch
+   gdtSetGate(GDT_TLS_ENTRY, 0, 0xFFFFFFFF, 0xF2, 0xCF);
+
    flushGdt();
 }
 
@@ -27,13 +32,17 @@ void flushGdt() {
 }
 
 void gdtSetGate(unsigned int num, uint32_t base, uint32_t limit, uint8_t access, uint8_t gran) {
-   gdt_entries[num].base_low    = (base & 0xFFFF);
-   gdt_entries[num].base_middle = (base >> 16) & 0xFF;
-   gdt_entries[num].base_high   = (base >> 24) & 0xFF;
+   gdtSetEntry(gdt_entries, num, base, limit, access, gran);
+}
+
+void gdtSetEntry(gdt_entry_t* gdt, unsigned int num, uint32_t base, uint32_t limit, uint8_t access, uint8_t gran) {
+   gdt[num].base_low    = (base & 0xFFFF);
+   gdt[num].base_middle = (base >> 16) & 0xFF;
+   gdt[num].base_high   = (base >> 24) & 0xFF;
 
-   gdt_entries[num].limit_low   = (limit & 0xFFFF);
-   gdt_entries[num].granularity = (limit >> 16) & 0x0F;
+   gdt[num].limit_low   = (limit & 0xFFFF);
+   gdt[num].granularity = (limit >> 16) & 0x0F;
 
-   gdt_entries[num].granularity |= gran & 0xF0;
-   gdt_entries[num].access      = access;
+   gdt[num].granularity |= gran & 0xF0;
+   gdt[num].access      = access;
 }
@@ -2,6 +2,20 @@
 #define _GDT_DEFINITIONS_DEF_H_
 #include <types/stdint.h>
 
+#define NUM_GDT_ENTRIES 8
+
+//The TSS of the CPU using the GDT
+#define GDT_TSS_ENTRY 5
+
+//The per-CPU data segment. Every CPU loads its own copy of the GDT where this entry is based at its cpu_t
+//so gs:0 always refers to the data of the CPU executing the instruction
+#define GDT_PERCPU_ENTRY 6
+#define GDT_PERCPU_SELECTOR 0x30
+
+//The thread local storage segment. Processes keep it loaded in fs, and whenever a process is switched to the entry
+//in the GDT of its CPU is based at its TLS block so fs:0 refers to the block of the running thread
+#define GDT_TLS_ENTRY 7
+#define GDT_TLS_SELECTOR 0x3B
 
 //This structure is the structure of a single entry onto the GDT (Global descriptor table)
 struct gdt_entry_struct
@@ -24,5 +38,17 @@ struct gdt_ptr_struct
 typedef struct gdt_ptr_struct gdt_ptr_t;
 
 void initializeGdt();
+void flushGdt();
+
+/**
+ * Set entry num of the GDT given
+ */
+void gdtSetEntry(gdt_entry_t* gdt, unsigned int num, uint32_t base, uint32_t limit, uint8_t access, uint8_t gran);
+void gdtSetGate(unsigned int num, uint32_t base, uint32_t limit, uint8_t access, uint8_t gran);
+
+/**
+ * The GDT built at boot, copied by each CPU as it comes online
+ */
+extern gdt_entry_t gdt_entries[NUM_GDT_ENTRIES];
 
 #endif //_GDT_DEFINITIONS_DEF_H_
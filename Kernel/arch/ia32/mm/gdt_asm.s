@@ -9,8 +9,9 @@ gdt_flush:
    mov ds, ax        ; Load all data segment selectors
    mov es, ax
    mov fs, ax
-   mov gs, ax
    mov ss, ax
+   mov ax, 0x30      ; 0x30 is the per-CPU data segment, gs always points at the CPU's data in the kernel
+   mov gs, ax
    jmp 0x08:.flush   ; 0x08 is the offset to our code segment: Far jump!
 .flush:
    ret
@@ -2,15 +2,16 @@
 #include <mm/gdt.h>
 #include <mm/phys_mm.h>
 #include <tss/tss.h>
+#include <cpu/percpu.h>
 #include <stack/stack.h>
 #include <stack/kstack.h>
 #include <printf.h>
 
 void initializeMemory(struct multiboot* mboot_ptr, MEM_LOC kernel_start, MEM_LOC kernel_end, MEM_LOC initial_esp) {
 
-	//Initializes the global descriptor table and the TSS
+	//Initializes the global descriptor table and the TSS, the boot processor then switches to its own copy of the GDT
 	initializeGdt();
-	initializeTss();
+	cpuInitialize(cpuBootProcessor());
 	printf("GDT [OK]\n");
 
 	//Initializes the memory manager and maps free pages
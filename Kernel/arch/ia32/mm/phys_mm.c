@@ -5,7 +5,7 @@
 #include <types/memory.h>
 #include <scheduler/scheduler.h>
 #include <process/used_list.h>
-#include <panic/panic.h>
+#include <lock/spinlock.h>
 
 MEM_LOC used_mem_end = 0;
 MEM_LOC phys_mm_slock = PHYS_MM_STACK_ADDR;
@@ -13,6 +13,9 @@ MEM_LOC phys_mm_smax = PHYS_MM_STACK_ADDR;
 
 extern uint32_t paging_enabled;
 
+//Protects the free frame stack, taken with interrupts disabled as frames can be freed from interrupt handlers
+static spinlock_t physicalMemoryLock = SPINLOCK_INIT("physical memory");
+
 void initializePhysicalMemoryManager(MEM_LOC start) {
 	DEBUG_PRINT("Debug Message: Used memory end 0x%x\n", start);
 	//This ensures that the used_mem_end address is on a page-aligned boundry
@@ -31,10 +34,14 @@ MEM_LOC allocateFrame() {
 		used_mem_end += 4096; //Add 4096 bytes (4kb) to used_mem_end address
 		return used_mem_end - 4096; //Return the old address
 	} else {
+		irq_flags_t flags = spinlockAcquireIrqSave(&physicalMemoryLock);
+
 		ASSERT(phys_mm_slock != PHYS_MM_STACK_ADDR, "out of memory frames");
 		phys_mm_slock -= sizeof(uint32_t);
-		uint32_t* stack = (uint32_t*) phys_mm_slock;
-		return *stack;
+		MEM_LOC frame = *((uint32_t*) phys_mm_slock);
+
+		spinlockReleaseIrqRestore(&physicalMemoryLock, flags);
+		return frame;
 	}
 }
 
@@ -43,8 +50,9 @@ MEM_LOC allocateFrameForProcess(process_t* req_process) {
 	ASSERT(paging_enabled, "cannot allocate for process without paging");
 	MEM_LOC frame = allocateFrame();
 
+	//Frames mapped by a thread belong to the address space it shares with its process
 	if (req_process) {
-		usedListAdd(req_process, frame);
+		usedListAdd(processLeader(req_process), frame);
 	}
 
 	return frame;
@@ -52,6 +60,15 @@ MEM_LOC allocateFrameForProcess(process_t* req_process) {
 
 void freeFrame(MEM_LOC frame) {
 
+	if (getCurrentProcess() != 0) {
+		usedListRemove(processLeader(getCurrentProcess()), frame);
+	}
+
+	freeUnownedFrame(frame);
+}
+
+void freeUnownedFrame(MEM_LOC frame) {
+
 	//If paging isn't enabled we are not going to be able to free a frame of virtual memory
 	//and the stacks location is virtual (Cannot be accessed without paging)
 	if (paging_enabled == 0) {
@@ -64,9 +81,7 @@ void freeFrame(MEM_LOC frame) {
 		return;
 	}
 
-	if (getCurrentProcess() != 0) {
-		usedListRemove(getCurrentProcess(), frame);
-	}
+	irq_flags_t flags = spinlockAcquireIrqSave(&physicalMemoryLock);
 
 	//Run out of stack space *Shock Horror* Allocate this frame to the end
 	//of the stack (Giving another 4kb (4096 bytes) of stack space)
@@ -79,6 +94,8 @@ void freeFrame(MEM_LOC frame) {
 		*stack = frame;
 		phys_mm_slock += sizeof(uint32_t);
 	}
+
+	spinlockReleaseIrqRestore(&physicalMemoryLock, flags);
 }
 
 /**
@@ -12,6 +12,8 @@
 #include <interrupts/interrupt_handler.h>
 #include <interrupts/interrupts.h>
 #include <mm/virtual.h>
+#include <lock/spinlock.h>
+#include <scheduler/scheduler.h>
 
 #define _reload_cr3() \
       __asm__ __volatile__ ("push %eax;mov %cr3,%eax;mov %eax,%cr3;pop %eax");
@@ -25,6 +27,10 @@ uint8_t paging_enabled = 0;
 page_directory_t* current_pagedir = 0;
 page_directory_t* kernel_pagedir = 0;
 
+//Held while the kernel borrows free addresses in the reserved region for temporary mappings, otherwise two
+//CPUs could pick the same free address
+static spinlock_t temporaryMappingLock = SPINLOCK_INIT("temporary mappings");
+
 uint32_t* page_directory = (uint32_t*) PAGE_DIR_VIRTUAL_ADDR;
 uint32_t* page_tables = (uint32_t*) PAGE_TABLE_VIRTUAL_ADDR;
 
@@ -71,9 +77,11 @@ void ia32_map(MEM_LOC va, MEM_LOC pa, uint32_t flags) {
 	// If the page table does not exist then create a new one for it.
 	if (page_directory[pt_idx] == 0) {
 
-		//Null page table (Needs to be created) so allocate a frame and initialize (Null) it.
-		page_directory[pt_idx] = (allocateFrame()) | PAGE_PRESENT | PAGE_USER
-				| PAGE_WRITE;
+		//Null page table (Needs to be created) so allocate a frame and initialize (Null) it. Tables below the kernel
+		//belong to the address space of the current process and are freed with it
+		MEM_LOC table = va < KERNEL_START && getCurrentProcess() ? allocateFrameForProcess(getCurrentProcess())
+				: allocateFrame();
+		page_directory[pt_idx] = table | PAGE_PRESENT | PAGE_USER | PAGE_WRITE;
 
 		//Reload the CR3 register to update virtual mappings
 		_reload_cr3();
@@ -299,32 +307,17 @@ MEM_LOC copyPageTable(MEM_LOC pt, uint8_t copy, process_t* process) {
 	return new_page_table;
 }
 
-page_directory_t* copyPageDir(page_directory_t* pagedir, process_t* process) {
-	disableInterrupts(); //Disable interrupts
-
-	page_directory_t* return_location =
-			(page_directory_t*) allocateFrameForProcess(process);
-
-	LPOINTER being_copied = kernelFirstFreeVirtualAddress();
-	map(being_copied, pagedir, MEMORY_RESTRICTED_ACCESS);
-
-	LPOINTER copying_to = kernelFirstFreeVirtualAddress();
-	map(copying_to, return_location, MEMORY_RESTRICTED_ACCESS);
-	memset(copying_to, 0, PAGE_SIZE);
+/**
+ * Fill in what every page directory shares: the identity mapped first table, the kernel tables, the second last
+ * table (copied from being_copied, with its last entry pointing at the new directory) and the loop back entry.
+ * temporaryMappingLock must be held
+ */
+static void setupSharedTables(LPOINTER copying_to, LPOINTER being_copied, page_directory_t* return_location,
+		process_t* process) {
 
-	//First 4 megabytings are ID Mapped. Kernel pages are identical across all page directories. The rest gets copied
+	//First 4 megabytings are ID Mapped. Kernel pages are identical across all page directories
 	copying_to[0] = being_copied[0];
 
-	for (unsigned int i = 1; i < getTable(KERNEL_START); i++) {
-		if ((being_copied[i]) != 0) {
-			MEM_LOC Location = copyPageTable(being_copied[i] & ~(0xFFF), 1,
-					process);
-			copying_to[i] = Location | PAGE_PRESENT | PAGE_USER | PAGE_WRITE;
-		} else {
-			copying_to[i] = 0;
-		}
-	}
-
 	for (unsigned int i = getTable(KERNEL_START); i < 1022; i++) {
 		copying_to[i] = being_copied[i];
 	}
@@ -349,10 +342,64 @@ page_directory_t* copyPageDir(page_directory_t* pagedir, process_t* process) {
 	unmap(opt);
 
 	copying_to[1023] = ((MEM_LOC) return_location & PAGE_MASK) | PAGE_PRESENT | PAGE_USER; //Loop back address
+}
+
+page_directory_t* copyPageDir(page_directory_t* pagedir, process_t* process) {
+	spinlockAcquire(&temporaryMappingLock);
+
+	page_directory_t* return_location =
+			(page_directory_t*) allocateFrameForProcess(process);
+
+	LPOINTER being_copied = kernelFirstFreeVirtualAddress();
+	map(being_copied, pagedir, MEMORY_RESTRICTED_ACCESS);
+
+	LPOINTER copying_to = kernelFirstFreeVirtualAddress();
+	map(copying_to, return_location, MEMORY_RESTRICTED_ACCESS);
+	memset(copying_to, 0, PAGE_SIZE);
+
+	//The rest gets copied
+	for (unsigned int i = 1; i < getTable(KERNEL_START); i++) {
+		if ((being_copied[i]) != 0) {
+			MEM_LOC Location = copyPageTable(being_copied[i] & ~(0xFFF), 1,
+					process);
+			copying_to[i] = Location | PAGE_PRESENT | PAGE_USER | PAGE_WRITE;
+
+			//Our temporary mappings stay in place, so the lock can be let go between tables to let the process be preempted
+			spinlockRelease(&temporaryMappingLock);
+			schedulerPreemptionPoint();
+			spinlockAcquire(&temporaryMappingLock);
+		} else {
+			copying_to[i] = 0;
+		}
+	}
+
+	setupSharedTables(copying_to, being_copied, return_location, process);
 
 	unmap(being_copied);
 	unmap(copying_to);
 
+	spinlockRelease(&temporaryMappingLock);
+	return return_location;
+}
+
+page_directory_t* createPageDir(process_t* process) {
+	spinlockAcquire(&temporaryMappingLock);
+
+	page_directory_t* return_location = (page_directory_t*) allocateFrameForProcess(process);
+
+	LPOINTER kernel_dir = kernelFirstFreeVirtualAddress();
+	map(kernel_dir, kernel_pagedir, MEMORY_RESTRICTED_ACCESS);
+
+	LPOINTER new_dir = kernelFirstFreeVirtualAddress();
+	map(new_dir, return_location, MEMORY_RESTRICTED_ACCESS);
+	memset(new_dir, 0, PAGE_SIZE);
+
+	setupSharedTables(new_dir, kernel_dir, return_location, process);
+
+	unmap(kernel_dir);
+	unmap(new_dir);
+
+	spinlockRelease(&temporaryMappingLock);
 	return return_location;
 }
 
@@ -6,6 +6,7 @@
 #define PAGE_WRITE     0x2
 #define PAGE_USER      0x4
 #define PAGE_WRITETHROUGH 0x8
+#define PAGE_CACHE_DISABLE 0x10
 
 #define PAGE_DIR_VIRTUAL_ADDR   0xFFBFF000
 #define PAGE_TABLE_VIRTUAL_ADDR 0xFFC00000
@@ -18,6 +19,11 @@
 #define KERNEL_RESERVED_START KERNEL_START + 0x20000000
 #define KERNEL_MEMORY_END 0xFFFFFFFF
 
+//Fixed kernel mappings at the top of the kernel heap region, shared by every page directory
+#define FIXED_MAP_ACPI_WINDOW 0xDFFF0000 //8 pages used to read the MP and ACPI tables
+#define FIXED_MAP_ACPI_WINDOW_PAGES 8
+#define FIXED_MAP_LAPIC 0xDFFFE000 //The local APIC registers (every CPU sees its own APIC here)
+
 #include <mm/pagedir.h>
 #include <types/memory.h>
 #include <process/process.h>
@@ -29,6 +35,16 @@ void ia32_map (MEM_LOC va, MEM_LOC pa, uint32_t flags);
 void ia32_unmap (POINTER va);
 
 char get_mapping (MEM_LOC va, MEM_LOC* pa);
+
+/**
+ * Returns 1 if va is mapped in the current address space, setting pa (if not 0) to the physical address it maps to
+ */
+char getMapping(MEM_LOC va, MEM_LOC* pa);
 page_directory_t* copyPageDir(page_directory_t* pagedir, process_t* process);
 
+/**
+ * Create a page directory with nothing mapped below the kernel, only the tables every address space shares
+ */
+page_directory_t* createPageDir(process_t* process);
+
 #endif //_VIRTUAL_MEMORY_MANAGER_DEF_H_
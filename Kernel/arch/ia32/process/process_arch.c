@@ -11,81 +11,65 @@
 #include <interrupts/interrupts.h>
 #include <fs/vfs.h>
 #include <messages/messages.h>
+#include <lock/atomic.h>
+#include <tss/tss.h>
+#include <cpu/fpu.h>
+#include <mm/virtual.h>
+#include <system/kernel_data.h>
+#include <cpu/percpu.h>
+#include <mm/gdt.h>
+#include <lock/spinlock.h>
+#include <printf.h>
+#include <process/accounting.h>
+#include <process/subscriptions.h>
+
+/**
+ * Located in switch.s
+ */
+extern void switch_to(MEM_LOC* fromEsp, MEM_LOC toEsp, page_directory_t* toDir);
+extern uint32_t fork_context(MEM_LOC* childEsp, void (*copy)(void*), void* data);
+extern void process_start();
 
-extern MEM_LOC read_eip();
 static process_t* kernel_proc = 0;
-static unsigned int next_pid = 0;
+static volatile uint32_t next_pid = 0;
 extern terminal_t* g_kernelTerminal;
 
-static const int cProcessSwapMagic = 0x12345;
-
 #define PROCESS_HEAP_START 0xA0000000
+#define IDLE_STACK_SIZE 0x2000
 
-typedef struct {
+/**
+ * Map (if it isn't already, a fork child has a copy of its parents) and fill in the process data page of the current
+ * process
+ */
+static void setupProcessDataPage(process_t* process) {
 
-	/**
-	 * The name of the file to load
-	 */
-	char* filename;
-
-	/**
-	 * From what directory should the search for this file begin
-	 */
-	fs_node_t* fromWhere;
-
-	/**
-	 * Should the application be run in systems software mode (needs access
-	 * to privileged instructions) or user mode (Limited access, better control
-	 * by OS, safer)
-	 */
-	int userMode;
-
-} new_process_orders_t;
-
-new_process_orders_t* makeOrders(const char* Where, fs_node_t* fromWhere) {
-	new_process_orders_t* createdOrder = malloc(sizeof(new_process_orders_t));
-	memset(createdOrder, 0, sizeof(new_process_orders_t));
-	createdOrder->filename = malloc(strlen(Where) + 1);
-	strcpy(createdOrder->filename, Where);
-	createdOrder->fromWhere = fromWhere;
-	return createdOrder;
-}
+	if (!getMapping(PROCESS_DATA_PAGE_ADDRESS, 0)) {
+		map(PROCESS_DATA_PAGE_ADDRESS, allocateFrameForProcess(process), MEMORY_RESTRICTED_ACCESS);
+		memset((void*) PROCESS_DATA_PAGE_ADDRESS, 0, PAGE_SIZE);
+	}
 
-void freeOrders(new_process_orders_t* orders) {
-	free(orders->filename);
-	free(orders);
+	process_data_page_t* page = (process_data_page_t*) PROCESS_DATA_PAGE_ADDRESS;
+	page->pid = process->id;
+	page->parentPid = process->parentId;
 }
 
 /**
- * Acts as a entry point for new OS processes
+ * Give a process that has never run the frame switch_to expects, so the first switch to it calls entry(first, second)
+ * on the stack given. The frame itself is built below frameTop, which has to be visible from the address space doing
+ * the switch
  */
-void newProcessEntryPoint() {
-
-	process_message msg;
-	if (postboxTop(&getCurrentProcess()->processPostbox, &msg) && msg.ID == LOAD_MESSAGE) {
-		int userMode = 0;
-		new_process_orders_t* orders =
-				(new_process_orders_t*) msg.messageAdditionalData;
-
-		fs_node_t* node = evaluatePath(orders->filename, orders->fromWhere);
-		userMode = orders->userMode;
-		renameCurrentProcess(orders->filename);
-		freeOrders(orders);
-
-		if (!node || !node->parent) {
-			DEBUG_PRINT("Unable to evaluate node. process could not load file specified\n");
-			schedulerKillCurrentProcess();
-		} else {
-			setProcessExecutionDirectory(getCurrentProcess(), node->parent);
-			loadAndExecuteProgram(node, userMode);
-		}
-		schedulerKillCurrentProcess();
-	} else {
-		DEBUG_PRINT("Invalid message. Killing self\n");
-		schedulerKillCurrentProcess();
-	}
-
-	PANIC("Should never get here");
+static void setupInitialContext(process_t* process, MEM_LOC frameTop, MEM_LOC stack, void (*entry)(), MEM_LOC first,
+		MEM_LOC second) {
+	MEM_LOC* frame = ((MEM_LOC*) frameTop) - 6;
+
+	frame[0] = GDT_TLS_SELECTOR; //fs
+	frame[1] = second; //edi
+	frame[2] = first; //esi
+	frame[3] = (MEM_LOC) entry; //ebx
+	frame[4] = stack; //ebp
+	frame[5] = (MEM_LOC) process_start;
+
+	process->esp = (MEM_LOC) frame;
 }
 
 process_t* initializeKernelProcess() {
@@ -102,6 +86,8 @@ process_t* initializeKernelProcess() {
 
 		kernelProcess->pageDir = kernel_pagedir;
 		kernelProcess->executionDirectory = get_vfs();
+		kernelProcess->kernelStack = kernelStackAllocate();
+		kernelProcess->addressSpaceUsers = 1;
 		kernel_proc = kernelProcess;
 		initializeUsedList(kernel_proc);
 		kernelProcess->processTerminal = g_kernelTerminal;
@@ -110,21 +96,124 @@ process_t* initializeKernelProcess() {
 	return kernel_proc;
 }
 
+process_t* initializeIdleProcess() {
+	extern page_directory_t* kernel_pagedir;
+
+	process_t* idleProcess = (process_t*) malloc(sizeof(process_t));
+	memset(idleProcess, 0, sizeof(process_t));
+	strcpy(idleProcess->name, "Idle");
+
+	//Idle processes live in the kernel page directory on a stack from the kernel heap, so they can run on any CPU
+	idleProcess->pageDir = kernel_pagedir;
+	idleProcess->executionDirectory = get_vfs();
+	idleProcess->processTerminal = g_kernelTerminal;
+	idleProcess->addressSpaceUsers = 1;
+	initializeUsedList(idleProcess);
+
+	MEM_LOC stack = (MEM_LOC) malloc(IDLE_STACK_SIZE);
+	setupInitialContext(idleProcess, stack + IDLE_STACK_SIZE, stack + IDLE_STACK_SIZE, schedulerIdleEntry, 0, 0);
+
+	return idleProcess;
+}
+
+/**
+ * Wait for everybody that pinned the process to be done with it, nothing new can pin it once it is off the process list
+ */
+static void waitForPins(process_t* process) {
+
+	while (process->pins) {
+		schedulerYield();
+	}
+}
+
+/**
+ * Drop a user of the address space of the process given, freeing it along with the process structure once the last
+ * user is gone. Threads keep the structure of their leader alive as they use its postbox
+ */
+static void releaseAddressSpace(process_t* leader) {
+
+	if (atomicFetchAdd(&leader->addressSpaceUsers, -1) != 1) {
+		return;
+	}
+
+	usedListFree(leader);
+
+	subscriptionsSetFlags(leader, 0);
+
+	//Senders that pinned the process give up on the closed postbox
+	postboxFree(&leader->processPostbox);
+	waitForPins(leader);
+
+	free(leader);
+}
+
 void freeProcess(process_t* process) {
 
-	usedListFree(process);
+	if (process->kernelStack) {
+		kernelStackFree(process->kernelStack);
+	}
+
+	fpuFreeState(process);
+
+	process_t* leader = processLeader(process);
 
-	//Empty the postbox
-	process_message msg;
-	while (postboxTop(&process->processPostbox, &msg)) {}
+	if (leader != process) {
+		waitForPins(process);
+		free(process);
+	}
 
-	free(process);
+	releaseAddressSpace(leader);
 }
 
-int kfork() {
-	uint32_t esp, ebp;
+/**
+ * A user mode process forks from its kernel stack, which isn't part of the copied address space. Give the child a copy
+ * of it, moving its saved stack pointer (and every saved frame pointer) across to the childs stack
+ */
+static void copyKernelStack(process_t* parent, process_t* child) {
+	MEM_LOC top = parent->kernelStack + KERNEL_STACK_SIZE;
+	MEM_LOC offset = child->kernelStack - parent->kernelStack;
 
-	disableInterrupts();
+	memcpy((void*) child->kernelStack, (void*) parent->kernelStack, KERNEL_STACK_SIZE);
+
+	//The frame pointer saved by fork_context starts the chain
+	MEM_LOC* frameEbp = (MEM_LOC*) (child->esp + offset) + 4;
+
+	for (MEM_LOC frame = *frameEbp; frame >= child->esp && frame < top; frame = *((MEM_LOC*) frame)) {
+		MEM_LOC* saved = (MEM_LOC*) (frame + offset);
+
+		if (*saved >= parent->kernelStack && *saved < top) {
+			*saved += offset;
+		}
+	}
+
+	if (*frameEbp >= parent->kernelStack && *frameEbp < top) {
+		*frameEbp += offset;
+	}
+
+	child->esp += offset;
+}
+
+typedef struct {
+	process_t* parent;
+	process_t* child;
+} fork_copy_t;
+
+/**
+ * Called by fork_context once the childs frame is saved on the stack of the parent
+ */
+static void forkCopy(void* data) {
+	fork_copy_t* copy = (fork_copy_t*) data;
+	process_t* parent = copy->parent;
+	process_t* child = copy->child;
+
+	child->pageDir = copyPageDir(parent->pageDir, child);
+
+	if (child->esp >= parent->kernelStack && child->esp < parent->kernelStack + KERNEL_STACK_SIZE) {
+		copyKernelStack(parent, child);
+	}
+}
+
+int kfork() {
 
 	DEBUG_PRINT("Free frames at start %x\n", calculateFreeFrames());
 
@@ -139,43 +228,88 @@ int kfork() {
 	strcpy(new_process->name, "Forklet");
 
 	new_process->processTerminal = parent->processTerminal;
+	new_process->kernelStack = kernelStackAllocate();
+	new_process->addressSpaceUsers = 1;
+	new_process->tls = parent->tls;
+	new_process->handleUsers = 1;
 	initializeUsedList(new_process);
 
 	//Set the processes unique ID
-	next_pid++;
-	new_process->id = next_pid;
-
-	//Located in virt_mm.c
-	extern page_directory_t* current_pagedir;
+	new_process->id = atomicFetchAdd(&next_pid, 1) + 1;
+	new_process->parentId = parent->id;
 
 	//Set the root execution directory
-	new_process->executionDirectory = parent->executionDirectory;
+	new_process->executionDirectory = processLeader(parent)->executionDirectory;
 
-	//Copy the page directory
-	page_directory_t* newprocesspd = copyPageDir(current_pagedir, new_process);
+	fpuForkState(parent, new_process);
 
-	//Give it a page directory
-	new_process->pageDir = newprocesspd;
+	//Copy the page directory (and the kernel stack if need be) with the frame the child resumes from on the stack
+	fork_copy_t copy;
+	copy.parent = parent;
+	copy.child = new_process;
 
-	MEM_LOC current_eip = (MEM_LOC) read_eip();
-
-	if (parent->id == getCurrentProcess()->id) {
-		__asm__ volatile("mov %%esp, %0" : "=r"(esp));
-		__asm__ volatile("mov %%ebp, %0" : "=r"(ebp));
-		new_process->esp = esp;
-		new_process->ebp = ebp;
-		new_process->eip = current_eip;
-		schedulerAdd(new_process);
-		return 0; //Return 0 - Parent
-	} else {
+	if (fork_context(&new_process->esp, forkCopy, &copy)) {
+		schedulerSwitchFinished();
+		setupProcessDataPage(getCurrentProcess());
 		return 1; //Return 1 - Child
 	}
+
+	schedulerAdd(new_process);
+	return 0; //Return 0 - Parent
 }
 
-int createNewProcess(const char* filename, fs_node_t* where) {
-	uint32_t esp, ebp;
+/**
+ * Runs on the user stack of a new process once its image is loaded
+ */
+static void spawnExecute(executable_image_t* image) {
+	executableImageExecute(image, 0);
+	PANIC("Should never get here");
+}
 
-	disableInterrupts();
+/**
+ * Acts as the entry point of new OS processes. It runs on the kernel stack of the process in its new (empty) address
+ * space, maps the stack and image and then moves onto the stack to run it
+ */
+static void spawnEntryPoint(executable_image_t* image) {
+	schedulerSwitchFinished();
+
+	process_t* process = getCurrentProcess();
+	setupProcessDataPage(process);
+
+	for (MEM_LOC page = USER_STACK_START - USER_STACK_SIZE; page < USER_STACK_START; page += PAGE_SIZE) {
+		map(page, allocateFrameForProcess(process), 0);
+	}
+
+	if (executableImageLoad(image) != 0) {
+		DEBUG_PRINT("Process could not load file specified\n");
+		executableImageRelease(image);
+		schedulerKillCurrentProcess();
+	}
+
+	__asm__ volatile("mov %0, %%esp\n"
+			"xor %%ebp, %%ebp\n"
+			"push %1\n"
+			"call *%2" :: "r" (USER_STACK_START), "r" (image), "r" (spawnExecute));
+
+	PANIC("Should never get here");
+}
+
+int createNewProcess(const char* filename, fs_node_t* where, int stdinHandle, int stdoutHandle) {
+
+	//The file is found and its headers are validated before anything is created, so a bad path fails here
+	fs_node_t* node = evaluatePath(filename, where);
+
+	if (!node || !node->parent) {
+		DEBUG_PRINT("Unable to evaluate node. process could not load file specified\n");
+		return -1;
+	}
+
+	executable_image_t* image;
+
+	if (executableImageParse(node, &image) != 0) {
+		DEBUG_PRINT("File specified is not a valid executable\n");
+		return -1;
+	}
 
 	//Store this for later use
 	process_t* parent = schedulerGetProcessFromPid(0);
@@ -184,52 +318,97 @@ int createNewProcess(const char* filename, fs_node_t* where) {
 	process_t* new_process = malloc(sizeof(process_t));
 	memset(new_process, 0, sizeof(process_t));
 
-	//Give it a generic name fo-now
-	strcpy(new_process->name, "New Process");
+	setProcessName(new_process, filename);
 
 	//Setup terminal bindings
 	new_process->processTerminal = parent->processTerminal;
 
 	//Initialize the used frames list for the process
 	initializeUsedList(new_process);
+	new_process->kernelStack = kernelStackAllocate();
+	new_process->addressSpaceUsers = 1;
 
 	//Set the processes unique ID
-	next_pid++;
-	new_process->id = next_pid;
+	new_process->id = atomicFetchAdd(&next_pid, 1) + 1;
+	new_process->parentId = getCurrentProcess()->id;
 
-	//Located in virt_mm.c
-	extern page_directory_t* current_pagedir;
-	extern page_directory_t* kernel_pagedir;
+	//Run from the directory the file is in
+	new_process->executionDirectory = node->parent;
 
-	//Set the root execution directory
-	new_process->executionDirectory = parent->executionDirectory;
+	handlesInherit(new_process, stdinHandle, stdoutHandle);
+
+	//A fresh page directory, nothing of the kernel process below the kernel is copied
+	new_process->pageDir = createPageDir(new_process);
+
+	//Nothing but the kernel is mapped in the new address space yet, so the process starts on its kernel stack
+	setupInitialContext(new_process, new_process->kernelStack + KERNEL_STACK_SIZE,
+			new_process->kernelStack + KERNEL_STACK_SIZE, (void (*)()) spawnEntryPoint, (MEM_LOC) image,
+			0);
+
+	schedulerAdd(new_process);
+
+	return new_process->id; //Return the PID of the new process to the parent
+}
+
+/**
+ * Acts as the entry point of new threads, running on the stack the thread was given
+ */
+static void threadEntryPoint(MEM_LOC entry, MEM_LOC argument) {
+	schedulerSwitchFinished();
 
-	//Copy the page directory
-	page_directory_t* newprocesspd = copyPageDir(kernel_pagedir, new_process);
+	int returnValue = ((int (*)(void*)) entry)((void*) argument);
 
-	//Give it a page directory
-	new_process->pageDir = newprocesspd;
+	getCurrentProcess()->returnValue = returnValue;
+	schedulerKillCurrentProcess();
+}
 
-	MEM_LOC current_eip = (MEM_LOC) newProcessEntryPoint;
+int createThread(MEM_LOC entry, MEM_LOC argument, MEM_LOC stack, MEM_LOC tls) {
+	process_t* leader = processLeader(getCurrentProcess());
 
-	__asm__ volatile("mov %%esp, %0" : "=r"(esp));
-	__asm__ volatile("mov %%ebp, %0" : "=r"(ebp));
+	process_t* thread = malloc(sizeof(process_t));
+	memset(thread, 0, sizeof(process_t));
 
-	new_process->esp = USER_STACK_START;
-	new_process->ebp = USER_STACK_START;
-	new_process->eip = current_eip;
+	strcpy(thread->name, leader->name);
 
-	process_message InfomaticMessage;
-	InfomaticMessage.from_PID = getCurrentProcess()->id;
-	InfomaticMessage.ID = LOAD_MESSAGE;
-	InfomaticMessage.messageAdditionalData = (MEM_LOC) makeOrders(filename,
-			where);
+	//Everything but the stacks, the registers and the TLS segment belongs to the process
+	thread->threadLeader = leader;
+	atomicFetchAdd(&leader->addressSpaceUsers, 1);
 
-	postboxPush(&new_process->processPostbox, &InfomaticMessage);
+	thread->pageDir = leader->pageDir;
+	thread->processTerminal = leader->processTerminal;
+	thread->executionDirectory = leader->executionDirectory;
+	thread->kernelStack = kernelStackAllocate();
+	thread->tls = tls;
 
-	schedulerAdd(new_process);
+	handlesAddUser(leader);
 
-	return 0; //Return 0 - Parent
+	thread->id = atomicFetchAdd(&next_pid, 1) + 1;
+	thread->parentId = leader->id;
+
+	setupInitialContext(thread, thread->kernelStack + KERNEL_STACK_SIZE, stack, (void (*)()) threadEntryPoint, entry,
+			argument);
+
+	schedulerAdd(thread);
+	return thread->id;
+}
+
+/**
+ * Base the TLS segment in the GDT of the CPU executing the call at tls, interrupts have to be disabled
+ */
+static void loadTlsSegment(MEM_LOC tls) {
+	gdtSetEntry(getCpu()->gdt, GDT_TLS_ENTRY, tls, 0xFFFFFFFF, 0xF2, 0xCF);
+}
+
+void setThreadTls(MEM_LOC tls) {
+	irq_flags_t flags = interruptsSave();
+
+	getCurrentProcess()->tls = tls;
+	loadTlsSegment(tls);
+
+	//fs has to be reloaded for the new base to be used
+	__asm__ volatile("mov %0, %%fs" :: "r" (GDT_TLS_SELECTOR));
+
+	interruptsRestore(flags);
 }
 
 void switchProcess(process_t* from, process_t* to) {
@@ -237,38 +416,54 @@ void switchProcess(process_t* from, process_t* to) {
 	ASSERT(from && to, "from & to process have to be valid for switchProcess");
 	disableInterrupts();
 
-	uint32_t esp, ebp, eip;
+	//Interrupts and syscalls from user mode land on the kernel stack of whichever process is running
+	if (to->kernelStack) {
+		setKernelStack(to->kernelStack + KERNEL_STACK_SIZE);
+	}
 
-	__asm__ volatile("mov %%esp, %0" : "=r"(esp));
-	__asm__ volatile("mov %%ebp, %0" : "=r"(ebp));
+	fpuSwitch(from, to);
 
-	eip = read_eip();
+	//Everything from here is charged to whatever runs next on this CPU
+	accountingCharge(from);
 
-	if (eip == cProcessSwapMagic) {
-		//If this is triggered then we have just switched tasks so return
-		return;
+	//The GDT of each CPU holds the TLS base of whatever it is running, switch_to reloads fs with it
+	if (to->tls != from->tls) {
+		loadTlsSegment(to->tls);
 	}
 
-	from->eip = eip;
-	from->esp = esp;
-	from->ebp = ebp;
+#if _SWITCH_STATS_
+	cpu_t* cpu = getCpu();
+	cpu->switchReloadsCr3 = from->pageDir != to->pageDir;
+	cpu->switchStartTsc = readTimestampCounter();
+#endif
+
+	//Interrupts stay off, the scheduler lock is still held and the process being switched to re-enables them.
+	//switch_to returns once something switches back to from
+	switch_to(&from->esp, to->esp, to->pageDir);
+
+#if _SWITCH_STATS_
+	//Running as from again, but on whichever CPU switched back to it
+	cpu = getCpu();
+	cpu->switchCount[cpu->switchReloadsCr3]++;
+	cpu->switchCycles[cpu->switchReloadsCr3] += readTimestampCounter() - cpu->switchStartTsc;
+#endif
+}
+
+void switchDebugReport() {
 
-	eip = to->eip;
-	esp = to->esp;
-	ebp = to->ebp;
-	page_directory_t* pagedir = to->pageDir;
+#if _SWITCH_STATS_
+	printf("Context switches (cpu, same directory switches, average cycles, directory changes, average cycles)\n");
 
-	extern page_directory_t* current_pagedir;
-	current_pagedir = pagedir;
+	for (unsigned int i = 0; i < cpuCount(); i++) {
+		cpu_t* cpu = cpuGet(i);
+		unsigned long average[2];
 
-	__asm__ volatile("cli; \
-		      mov %1, %%esp; \
-		      mov %2, %%ebp; \
-		      mov %0, %%ecx; \
-		      mov %3, %%cr3; \
-		      mov %4, %%eax; \
-		      sti; \
-		      jmp *%%ecx;" :: "r" (eip), "r" (esp), "r" (ebp), "r" (pagedir), "r" (cProcessSwapMagic));
+		for (unsigned int reload = 0; reload < 2; reload++) {
+			average[reload] = cpu->switchCount[reload] ?
+					cyclesDivide(cpu->switchCycles[reload], cpu->switchCount[reload]) : 0;
+		}
 
-	return;
+		printf("%i %i %i %i %i\n", cpu->id, cpu->switchCount[0], average[0], cpu->switchCount[1], average[1]);
+	}
+#endif
 }
@@ -3,9 +3,17 @@
 #include <mm/pagedir.h>
 #include <common.h>
 #include <process/postbox.h>
+#include <process/process_queue.h>
 #include <terminal/terminal.h>
 #include <heap/heap.h>
 #include <fs/vfs.h>
+#include <syscall/syscall_ring.h>
+#include <syscall/syscall_ipc.h>
+#include <process/handles.h>
+#include <process/poll.h>
+#include <lock/atomic.h>
+
+struct process_entry_t;
 
 /**
  * The process structure is an architecture specific structure which stores
@@ -21,19 +29,65 @@ typedef struct processStructure {
 	 */
 	unsigned int id;
 
+	/**
+	 * The ID of the process that requested this one be created
+	 */
+	unsigned int parentId;
+
 	/**
 	 * 64 byte character array to store the processes name
 	 */
 	char name[64];
 
-	MEM_LOC esp /* Stack pointer */, ebp /* Base Pointer */,
-			eip /* Instruction Pointer */; /* The rest is stored by the interrupt that triggers the switch */
+	/**
+	 * The stack pointer saved by switch_to when the process was switched away from, it points at the callee saved
+	 * registers and the address switch_to returns to. The rest is stored by the interrupt that triggers the switch
+	 */
+	MEM_LOC esp;
+
+	/**
+	 * The lowest address of the kernel stack of this process (0 for idle processes, which never leave the kernel)
+	 */
+	MEM_LOC kernelStack;
+
+	/**
+	 * Threads point at the process that created them, whose page directory, terminal, execution directory and
+	 * postbox they share (0 for every other process). addressSpaceUsers counts a process and each of its threads,
+	 * its address space (and the process structure) is only freed once the last of them has exited
+	 */
+	struct processStructure* threadLeader;
+	volatile uint32_t addressSpaceUsers;
+
+	/**
+	 * Code outside of the process using the structure after finding it on the process list (see
+	 * schedulerPinProcessFromPid). Whatever frees the structure waits for them to finish
+	 */
+	volatile uint32_t pins;
+
+	/**
+	 * The base of the TLS segment (fs) while this process runs
+	 */
+	MEM_LOC tls;
+
+	/**
+	 * The saved FPU and SSE registers, only allocated once the process first uses the FPU. fpuCpu is the ID (plus one)
+	 * of the CPU whose registers were last loaded with them
+	 */
+	void* fpuState;
+	unsigned int fpuCpu;
 
 	/**
 	 * The number of ticks spent processing this process
 	 */
 	unsigned long processingTime;
 
+	/**
+	 * TSC cycles charged to the process outside and inside of syscalls, and the TSC when it was started
+	 */
+	uint64_t userCycles;
+	uint64_t kernelCycles;
+	uint64_t startTsc;
+
 	/**
 	 * The flags set for what information this process wants to recieve in its postbox
 	 */
@@ -55,14 +109,102 @@ typedef struct processStructure {
 	fs_node_t* executionDirectory;
 
 	/**
-	 * A list of all the frames of memory mapped by this application
+	 * A list of all the frames of memory mapped by this application (only the list of the leader is used).
+	 * usedListLock protects it, as every thread of the process can map and unmap at once
 	 */
 	void** usedListRoot; //Root location of the used list
 	unsigned long usedListMaxItems;
 	unsigned long usedListNumItems; //Location of the end of the current list irrespect to the root
+	spinlock_t usedListLock;
+
+	/**
+	 * Held (in the leader) from finding free space in the grant region to mapping a grant into it, so threads
+	 * delivering grants at once don't pick the same pages. Taken before usedListLock
+	 */
+	spinlock_t grantLock;
 
 	unsigned char shouldDestroy;
 
+	/**
+	 * Set while the process is sleeping on a process queue, the scheduler will skip it until it is woken
+	 */
+	unsigned char blocked;
+
+	/**
+	 * The next process on whatever process queue (wait queue, zombie queue) this process is on
+	 */
+	struct processStructure* queueNext;
+
+	/**
+	 * The clock tick a process on the sleep queue is woken at and the next process on the sleep queue. A process
+	 * blocked with a timeout is on the sleep queue and a wait queue at once
+	 */
+	unsigned long wakeTick;
+	struct processStructure* sleepNext;
+	unsigned char sleeping;
+
+	/**
+	 * The wait queue the process is blocked on (0 if none), and whether its last timed block ran out instead
+	 */
+	process_queue_t* waitQueue;
+	unsigned char timedOut;
+
+	/**
+	 * Synchronous IPC. ipcCallers are the processes blocked calling this one that it hasn't received yet and
+	 * ipcReceived the ones it has received but not replied to, both linked through ipcNext. Either end of a call
+	 * sleeps on its own ipcWait, ipcMessage holds the message passed to it and ipcFrom who it was received from
+	 */
+	struct processStructure* ipcCallers;
+	struct processStructure* ipcReceived;
+	struct processStructure* ipcNext;
+	process_queue_t ipcWait;
+	ipc_message_t ipcMessage;
+	unsigned int ipcFrom;
+	unsigned char ipcState;
+	int ipcResult;
+
+	/**
+	 * The handles the process has open, shared with its threads (only the table of the leader is used). handleUsers
+	 * counts the leader and the threads that haven't exited yet, the handles are closed once it drops to 0
+	 */
+	handle_t handles[PROCESS_MAX_HANDLES];
+	unsigned int handleUsers;
+	spinlock_t handleLock;
+
+	/**
+	 * The sources the process is waiting on (in the leader, created by the first registration and protected by its
+	 * handleLock), freed along with its handles
+	 */
+	poll_set_t* pollSet;
+
+	/**
+	 * The entry the scheduler keeps for the process (0 for idle processes)
+	 */
+	struct process_entry_t* schedulerEntry;
+
+	/**
+	 * The syscall ring registered by this process (in its own address space) and the number of syscalls it is inside of
+	 */
+	syscall_ring_t* syscallRing;
+	unsigned int syscallDepth;
+
+	/**
+	 * The number (plus one) of the poll registration told when the ring completes something, 0 if there isn't one
+	 */
+	unsigned int ringPoll;
+
+	/**
+	 * Processes blocked waiting for this process to exit. exitWaiterCount is the number of them that
+	 * still need to read returnValue, the process will not be freed until it drops to 0
+	 */
+	process_queue_t exitWaiters;
+	unsigned int exitWaiterCount;
+
+	/**
+	 * Set once a waiter has collected the return value of this process
+	 */
+	unsigned char exitCollected;
+
 	/**
 	 * The terminal that gets written to when this application prints
 	 */
@@ -74,10 +216,58 @@ typedef struct processStructure {
 	int returnValue;
 } process_t;
 
+/**
+ * Returns the process owning the address space, terminal, execution directory and postbox of the process given, the
+ * process itself unless it is a thread
+ */
+static inline process_t* processLeader(process_t* process) {
+	return process->threadLeader ? process->threadLeader : process;
+}
+
+/**
+ * Keep the structure of a process around while it is used / let it go. Only a process that is already pinned (or
+ * its leader, which a pinned thread keeps alive) can be pinned again this way
+ */
+static inline void processPin(process_t* process) {
+	atomicFetchAdd(&process->pins, 1);
+}
+
+static inline void processUnpin(process_t* process) {
+	atomicFetchAdd(&process->pins, -1);
+}
+
 void switchProcess(process_t* from, process_t* proc);
 void setProcessInputBuffer(process_t* process, char* data, unsigned int len);
-int createNewProcess(const char* filename, fs_node_t* originFilesystemNode);
+/**
+ * Run the executable at filename (relative to originFilesystemNode) as a new process, returning its PID or -1. It gets
+ * the inheritable handles of the current process, with the handles given (unless they are HANDLE_NONE) as its input
+ * and output
+ */
+int createNewProcess(const char* filename, fs_node_t* originFilesystemNode, int stdinHandle, int stdoutHandle);
 int kfork();
+
+/**
+ * Start a thread of the current process running entry(argument) on the stack given, with its TLS segment based at
+ * tls. Returns the ID of the thread, which exits with the value entry returns
+ */
+int createThread(MEM_LOC entry, MEM_LOC argument, MEM_LOC stack, MEM_LOC tls);
+
+/**
+ * Move the TLS segment of the current process to tls
+ */
+void setThreadTls(MEM_LOC tls);
 process_t* initializeKernelProcess();
 
+/**
+ * Create the process a CPU runs when it has nothing else to do. It is never added to the scheduler's process list
+ */
+process_t* initializeIdleProcess();
+void freeProcess(process_t* process);
+
+/**
+ * Print how many context switches each CPU has made and how many cycles they took on average (only does anything
+ * when built with SWITCH_STATS=1)
+ */
+void switchDebugReport();
+
 #endif //_PROCESS_ARCH_H_
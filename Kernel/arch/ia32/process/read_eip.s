@@ -1,4 +0,0 @@
-[GLOBAL read_eip]
-read_eip:
-  pop eax
-  jmp eax
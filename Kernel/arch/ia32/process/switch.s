@@ -0,0 +1,77 @@
+[BITS 32]
+[GLOBAL switch_to]
+[GLOBAL fork_context]
+[GLOBAL process_start]
+
+; void switch_to(MEM_LOC* fromEsp, MEM_LOC toEsp, page_directory_t* toDir)
+; Saves the callee saved registers on the stack being left and its stack pointer in fromEsp, then loads toEsp and
+; returns on that stack to whoever saved it. cr3 is only reloaded (and the TLB flushed) if toDir is not already loaded,
+; so switching between threads sharing a page directory leaves the TLB alone. Every saved stack holds the same frame:
+; fs, edi, esi, ebx, ebp and the address to return to. Popping fs reloads the TLS segment switchProcess just rebased
+switch_to:
+   mov eax, [esp+4]
+   mov edx, [esp+8]
+   mov ecx, [esp+12]
+
+   push ebp
+   push ebx
+   push esi
+   push edi
+   push fs
+   mov [eax], esp
+
+   mov eax, cr3
+   cmp eax, ecx
+   je .same_directory
+   mov cr3, ecx
+
+.same_directory:
+   mov esp, edx
+   pop fs
+   pop edi
+   pop esi
+   pop ebx
+   pop ebp
+   ret
+
+; uint32_t fork_context(MEM_LOC* childEsp, void (*copy)(void*), void* data)
+; Saves a switch_to frame on the current stack, stores where it is in childEsp and calls copy(data) with the frame
+; still in place so the address space copy it makes holds the frame too. Returns 0, the child resumes from the frame
+; (the first time it is switched to) returning 1 from the same call
+fork_context:
+   mov eax, [esp+4]
+   mov ecx, [esp+8]
+   mov edx, [esp+12]
+
+   push .child
+   push ebp
+   push ebx
+   push esi
+   push edi
+   push fs
+   mov [eax], esp
+
+   push edx
+   call ecx
+   add esp, 28      ; The data argument and the frame, copy preserved the callee saved registers itself
+
+   xor eax, eax
+   ret
+
+.child:
+   mov eax, 1
+   ret
+
+; The first switch_to into a new process returns here with ebx holding the function to start, ebp the stack to start
+; it on and esi and edi the two arguments to pass it. The function never returns
+process_start:
+   mov esp, ebp
+   xor ebp, ebp
+   push edi
+   push esi
+   call ebx
+
+.hang:
+   cli
+   hlt
+   jmp .hang
@@ -7,6 +7,7 @@
 //The VGA Frame buffer starts at 0xB8000
 static uint16_t* video_memory_location = (uint16_t*) (KERNEL_START + 0xB8000);
 
+//Callers serialise through the terminal lock, apart from panics which write regardless
 static unsigned int cursor_x = 0;
 static unsigned int cursor_y = 0;
 
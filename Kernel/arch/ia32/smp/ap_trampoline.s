@@ -0,0 +1,76 @@
+; The code the application processors start in. It is copied to AP_TRAMPOLINE_ADDR (below 1MB)
+; and each AP is sent a STARTUP IPI pointing at it. The AP switches to protected mode with a
+; temporary flat GDT, turns on paging with ap_boot_cr3, loads ap_boot_esp and calls ap_boot_entry.
+; The ap_boot_ variables are filled in before the copy is made so the AP reads them from the copy
+
+AP_TRAMPOLINE_ADDR equ 0x8000
+
+; Address of a label once the trampoline has been copied
+%define TRAMPOLINE_ADDR(x) (x - ap_trampoline + AP_TRAMPOLINE_ADDR)
+
+[GLOBAL ap_trampoline]
+[GLOBAL ap_trampoline_end]
+[GLOBAL ap_boot_cr3]
+[GLOBAL ap_boot_esp]
+[GLOBAL ap_boot_entry]
+
+[BITS 16]
+ap_trampoline:
+   cli
+   cld
+   xor ax, ax
+   mov ds, ax
+
+   lgdt [TRAMPOLINE_ADDR(ap_gdt_ptr)]
+
+   mov eax, cr0
+   or eax, 0x1       ; Protected mode
+   mov cr0, eax
+
+   jmp dword 0x08:TRAMPOLINE_ADDR(ap_protected_mode)
+
+[BITS 32]
+ap_protected_mode:
+   mov ax, 0x10
+   mov ds, ax
+   mov es, ax
+   mov fs, ax
+   mov gs, ax
+   mov ss, ax
+
+   mov eax, [TRAMPOLINE_ADDR(ap_boot_cr3)]
+   mov cr3, eax
+
+   mov eax, cr0
+   or eax, 0x80000000 ; Paging, the trampoline is identity mapped so execution continues here
+   mov cr0, eax
+
+   mov esp, [TRAMPOLINE_ADDR(ap_boot_esp)]
+   mov ebp, esp
+
+   mov eax, [TRAMPOLINE_ADDR(ap_boot_entry)]
+   call eax
+
+.hang:
+   cli
+   hlt
+   jmp .hang
+
+align 8
+ap_gdt:
+   dq 0x0000000000000000 ; Null segment
+   dq 0x00CF9A000000FFFF ; Code segment (Present, ring0, Executable)
+   dq 0x00CF92000000FFFF ; Data segment (Present, ring0)
+
+ap_gdt_ptr:
+   dw ap_gdt_ptr - ap_gdt - 1
+   dd TRAMPOLINE_ADDR(ap_gdt)
+
+ap_boot_cr3:
+   dd 0
+ap_boot_esp:
+   dd 0
+ap_boot_entry:
+   dd 0
+
+ap_trampoline_end:
@@ -0,0 +1,84 @@
+#include <smp/lapic.h>
+#include <mm/virt_mm.h>
+#include <clock/clock.h>
+#include <interrupts/interrupts.h>
+
+//How many clock ticks to run the timer for when calibrating
+#define LAPIC_CALIBRATION_TICKS 10
+
+static unsigned char mapped = 0;
+
+void lapicMap(MEM_LOC physical) {
+	ia32_map(FIXED_MAP_LAPIC, physical & PAGE_MASK, PAGE_PRESENT | PAGE_WRITE | PAGE_WRITETHROUGH | PAGE_CACHE_DISABLE);
+	mapped = 1;
+}
+
+unsigned char lapicMapped() {
+	return mapped;
+}
+
+uint32_t lapicRead(uint32_t reg) {
+	return *((volatile uint32_t*) (FIXED_MAP_LAPIC + reg));
+}
+
+void lapicWrite(uint32_t reg, uint32_t value) {
+	*((volatile uint32_t*) (FIXED_MAP_LAPIC + reg)) = value;
+}
+
+unsigned int lapicId() {
+	return lapicRead(LAPIC_REG_ID) >> 24;
+}
+
+void lapicEnable() {
+	lapicWrite(LAPIC_REG_SPURIOUS, LAPIC_SPURIOUS_ENABLE | LAPIC_SPURIOUS_VECTOR);
+}
+
+void lapicEndOfInterrupt() {
+	lapicWrite(LAPIC_REG_EOI, 0);
+}
+
+uint32_t lapicCalibrateTimer() {
+	lapicWrite(LAPIC_REG_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_16);
+	lapicWrite(LAPIC_REG_LVT_TIMER, LAPIC_TIMER_MASKED | LAPIC_TIMER_VECTOR);
+
+	//Line up with the start of a tick then let the timer count down for a known number of ticks
+	unsigned long start = getClockTicks();
+
+	while (getClockTicks() == start) {
+		haltTillNextInterrupt();
+	}
+
+	lapicWrite(LAPIC_REG_TIMER_INITIAL, 0xFFFFFFFF);
+	start = getClockTicks();
+
+	while (getClockTicks() < start + LAPIC_CALIBRATION_TICKS) {
+		haltTillNextInterrupt();
+	}
+
+	uint32_t elapsed = 0xFFFFFFFF - lapicRead(LAPIC_REG_TIMER_CURRENT);
+	lapicWrite(LAPIC_REG_TIMER_INITIAL, 0);
+
+	return elapsed / LAPIC_CALIBRATION_TICKS;
+}
+
+void lapicStartTimer(uint32_t countsPerTick) {
+	lapicWrite(LAPIC_REG_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_16);
+	lapicWrite(LAPIC_REG_LVT_TIMER, LAPIC_TIMER_PERIODIC | LAPIC_TIMER_VECTOR);
+	lapicWrite(LAPIC_REG_TIMER_INITIAL, countsPerTick);
+}
+
+static void lapicSendIpi(unsigned int apicId, uint32_t command) {
+	lapicWrite(LAPIC_REG_ICR_HIGH, apicId << 24);
+	lapicWrite(LAPIC_REG_ICR_LOW, command);
+
+	//Wait for the APIC to accept the IPI
+	while (lapicRead(LAPIC_REG_ICR_LOW) & LAPIC_ICR_PENDING) {}
+}
+
+void lapicSendInit(unsigned int apicId) {
+	lapicSendIpi(apicId, LAPIC_ICR_INIT);
+}
+
+void lapicSendStartup(unsigned int apicId, uint8_t vector) {
+	lapicSendIpi(apicId, LAPIC_ICR_STARTUP | vector);
+}
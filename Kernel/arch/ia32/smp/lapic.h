@@ -0,0 +1,78 @@
+#ifndef _LOCAL_APIC_DEF_H_
+#define _LOCAL_APIC_DEF_H_
+#include <types/stdint.h>
+#include <types/memory.h>
+
+#define LAPIC_DEFAULT_ADDRESS 0xFEE00000
+
+#define LAPIC_REG_ID 0x20
+#define LAPIC_REG_EOI 0xB0
+#define LAPIC_REG_SPURIOUS 0xF0
+#define LAPIC_REG_ICR_LOW 0x300
+#define LAPIC_REG_ICR_HIGH 0x310
+#define LAPIC_REG_LVT_TIMER 0x320
+#define LAPIC_REG_TIMER_INITIAL 0x380
+#define LAPIC_REG_TIMER_CURRENT 0x390
+#define LAPIC_REG_TIMER_DIVIDE 0x3E0
+
+#define LAPIC_SPURIOUS_ENABLE 0x100
+
+//Routed to the IRQ15 stub which already ignores spurious interrupts from the PIC
+#define LAPIC_SPURIOUS_VECTOR 0x2F
+
+//The vector the local APIC timer fires on, interrupts from here up are acknowledged through the local APIC not the PIC
+#define LAPIC_TIMER_VECTOR 48
+
+#define LAPIC_TIMER_PERIODIC 0x20000
+#define LAPIC_TIMER_MASKED 0x10000
+#define LAPIC_TIMER_DIVIDE_16 0x3
+
+#define LAPIC_ICR_INIT 0x4500
+#define LAPIC_ICR_STARTUP 0x4600
+#define LAPIC_ICR_PENDING 0x1000
+
+/**
+ * Map the local APIC registers at FIXED_MAP_LAPIC, every CPU shares the mapping but sees its own APIC through it
+ */
+void lapicMap(MEM_LOC physical);
+
+/**
+ * Returns 1 once lapicMap has been called
+ */
+unsigned char lapicMapped();
+
+uint32_t lapicRead(uint32_t reg);
+void lapicWrite(uint32_t reg, uint32_t value);
+
+/**
+ * Returns the APIC ID of the CPU executing the call
+ */
+unsigned int lapicId();
+
+/**
+ * Software enable the local APIC of the CPU executing the call
+ */
+void lapicEnable();
+
+/**
+ * Signal the end of an interrupt delivered by the local APIC
+ */
+void lapicEndOfInterrupt();
+
+/**
+ * Measure how many local APIC timer counts pass in one clock tick, using the clock (which must be running)
+ */
+uint32_t lapicCalibrateTimer();
+
+/**
+ * Start the local APIC timer of the CPU executing the call, firing LAPIC_TIMER_VECTOR every countsPerTick counts
+ */
+void lapicStartTimer(uint32_t countsPerTick);
+
+/**
+ * Send an INIT IPI / a STARTUP IPI (starting execution at vector * 4096) to the CPU with the APIC ID given
+ */
+void lapicSendInit(unsigned int apicId);
+void lapicSendStartup(unsigned int apicId, uint8_t vector);
+
+#endif //_LOCAL_APIC_DEF_H_
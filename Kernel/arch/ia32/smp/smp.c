@@ -0,0 +1,159 @@
+#include <smp/smp.h>
+#include <smp/lapic.h>
+#include <cpu/cpu.h>
+#include <cpu/percpu.h>
+#include <cpu/fpu.h>
+#include <syscall/ia32_syscall.h>
+#include <mm/virt_mm.h>
+#include <interrupts/idt.h>
+#include <interrupts/interrupts.h>
+#include <interrupts/interrupt_handler.h>
+#include <scheduler/scheduler.h>
+#include <process/process.h>
+#include <clock/clock.h>
+#include <printf.h>
+#include <common.h>
+
+#define AP_TRAMPOLINE_ADDR 0x8000
+#define AP_STARTUP_VECTOR (AP_TRAMPOLINE_ADDR / 0x1000)
+
+//How long to wait in clock ticks after the INIT IPI, after each STARTUP IPI and for the AP to come online
+#define AP_INIT_DELAY 10
+#define AP_STARTUP_DELAY 1
+#define AP_ONLINE_TIMEOUT 100
+
+extern uint8_t ap_trampoline[];
+extern uint8_t ap_trampoline_end[];
+extern uint32_t ap_boot_cr3;
+extern uint32_t ap_boot_esp;
+extern uint32_t ap_boot_entry;
+
+extern struct idt_ptr idt_ptr;
+extern void idt_flush(uint32_t);
+extern page_directory_t* kernel_pagedir;
+
+/**
+ * The CPU currently being started, APs are started one at a time
+ */
+static cpu_t* volatile startingCpu = 0;
+
+/**
+ * The APs don't see the PIT so their local APIC timers drive their schedulers, ticking at the same rate as the clock
+ */
+static uint32_t timerCountsPerTick = 0;
+
+static idt_call_registers_t smpTimerTick(idt_call_registers_t regs) {
+	schedulerOnTick();
+	return regs;
+}
+
+static void smpWaitTicks(unsigned long ticks) {
+	unsigned long end = getClockTicks() + ticks;
+
+	while (getClockTicks() < end) {
+		haltTillNextInterrupt();
+	}
+}
+
+/**
+ * Where the APs go once the trampoline has enabled paging. The stack is the one of the CPUs idle process
+ * so the AP simply becomes its idle process once it is set up
+ */
+static void smpApEntry() {
+	cpu_t* cpu = startingCpu;
+
+	cpuInitialize(cpu);
+	idt_flush((uint32_t) &idt_ptr);
+	fpuInitializeCpu();
+	syscallInitializeFastEntry(cpu);
+	lapicEnable();
+	lapicStartTimer(timerCountsPerTick);
+
+	cpu->online = 1;
+
+	//From here the AP takes new processes and steals waiting ones from busier CPUs
+	schedulerActivateCpu(cpu);
+	schedulerIdleLoop();
+}
+
+static unsigned char smpStartCpu(cpu_t* cpu) {
+
+	//The idle process doubles as the boot stack of the AP
+	process_t* idle = initializeIdleProcess();
+	schedulerInitializeCpu(cpu, idle);
+
+	ap_boot_cr3 = (uint32_t) kernel_pagedir;
+	ap_boot_esp = idle->esp;
+	ap_boot_entry = (uint32_t) smpApEntry;
+	memcpy((void*) AP_TRAMPOLINE_ADDR, ap_trampoline, ap_trampoline_end - ap_trampoline);
+
+	startingCpu = cpu;
+
+	lapicSendInit(cpu->apicId);
+	smpWaitTicks(AP_INIT_DELAY);
+
+	//Older processors may miss the first STARTUP IPI so send a second if it has not come up
+	for (unsigned int attempt = 0; attempt < 2 && !cpu->online; attempt++) {
+		lapicSendStartup(cpu->apicId, AP_STARTUP_VECTOR);
+		smpWaitTicks(AP_STARTUP_DELAY);
+	}
+
+	unsigned long timeout = getClockTicks() + AP_ONLINE_TIMEOUT;
+
+	while (!cpu->online && getClockTicks() < timeout) {
+		haltTillNextInterrupt();
+	}
+
+	return cpu->online;
+}
+
+unsigned int initializeSmp() {
+	unsigned int apicIds[MAX_CPUS];
+	MEM_LOC lapicAddress = LAPIC_DEFAULT_ADDRESS;
+
+	if (!cpuidHasFeature(CPUID_FEATURE_APIC)) {
+		printf("SMP: No local APIC, running on the boot processor only\n");
+		return 1;
+	}
+
+	unsigned int found = smpDiscoverProcessors(&lapicAddress, apicIds, MAX_CPUS);
+
+	if (found < 2) {
+		printf("SMP: Single processor system\n");
+		return 1;
+	}
+
+	lapicMap(lapicAddress);
+	lapicEnable();
+
+	cpu_t* boot = cpuBootProcessor();
+	boot->apicId = lapicId();
+	boot->online = 1;
+
+	timerCountsPerTick = lapicCalibrateTimer();
+	registerInterruptHandler(LAPIC_TIMER_VECTOR, &smpTimerTick);
+
+	unsigned int online = 1;
+
+	for (unsigned int i = 0; i < found; i++) {
+
+		if (apicIds[i] == boot->apicId) {
+			continue;
+		}
+
+		cpu_t* cpu = cpuRegister(apicIds[i]);
+
+		if (!cpu) {
+			break;
+		}
+
+		if (smpStartCpu(cpu)) {
+			online++;
+		} else {
+			printf("SMP: CPU with APIC ID %i did not start\n", apicIds[i]);
+		}
+	}
+
+	printf("SMP: %i of %i CPUs online\n", online, found);
+	return online;
+}
@@ -0,0 +1,19 @@
+#ifndef _SYMMETRIC_MULTIPROCESSING_DEF_H_
+#define _SYMMETRIC_MULTIPROCESSING_DEF_H_
+#include <types/memory.h>
+#include <smp/lapic.h>
+
+/**
+ * Find the local APIC and the processors in the system from the ACPI MADT, or the MP tables if there is no MADT.
+ * Stores the APIC IDs of the enabled processors (including the boot processor) in apicIds, at most max of them,
+ * and returns how many were found. Returns 0 if neither table could be found
+ */
+unsigned int smpDiscoverProcessors(MEM_LOC* lapicAddress, unsigned int* apicIds, unsigned int max);
+
+/**
+ * Start every application processor in the system. Needs interrupts enabled (the clock is used to time the
+ * INIT-SIPI-SIPI sequence) and the scheduler initialized. Returns the number of CPUs now online
+ */
+unsigned int initializeSmp();
+
+#endif //_SYMMETRIC_MULTIPROCESSING_DEF_H_
@@ -0,0 +1,225 @@
+#include <smp/smp.h>
+#include <mm/virt_mm.h>
+#include <mm/virtual.h>
+#include <common.h>
+
+//The BIOS data area words holding the segment of the EBDA and the size of base memory in KB
+#define BDA_EBDA_SEGMENT 0x40E
+#define BDA_BASE_MEMORY_KB 0x413
+
+#define BIOS_ROM_START 0xE0000
+#define BIOS_ROM_END 0x100000
+
+#define MP_PROCESSOR_ENTRY 0
+#define MP_PROCESSOR_ENTRY_SIZE 20
+#define MP_OTHER_ENTRY_SIZE 8
+
+#define MADT_PROCESSOR_ENTRY 0
+
+#define RSDT_MAX_ENTRIES 64
+
+static unsigned char signatureMatches(const uint8_t* where, const char* signature) {
+
+	for (unsigned int i = 0; signature[i]; i++) {
+		if (where[i] != (uint8_t) signature[i]) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static unsigned char checksumValid(const uint8_t* table, unsigned int length) {
+	uint8_t sum = 0;
+
+	for (unsigned int i = 0; i < length; i++) {
+		sum += table[i];
+	}
+
+	return sum == 0;
+}
+
+/**
+ * Search the identity mapped low memory between start and end for a structure with the signature given,
+ * they are always 16 byte aligned
+ */
+static uint8_t* searchLowMemory(MEM_LOC start, MEM_LOC end, const char* signature, unsigned int checksumLength) {
+
+	for (MEM_LOC iter = start & ~0xF; iter + checksumLength <= end; iter += 16) {
+		if (signatureMatches((uint8_t*) iter, signature) && checksumValid((uint8_t*) iter, checksumLength)) {
+			return (uint8_t*) iter;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Search the EBDA, the top of base memory and then the BIOS ROM
+ */
+static uint8_t* searchBiosAreas(const char* signature, unsigned int checksumLength) {
+	MEM_LOC ebda = ((MEM_LOC) *((uint16_t*) BDA_EBDA_SEGMENT)) << 4;
+	MEM_LOC baseEnd = ((MEM_LOC) *((uint16_t*) BDA_BASE_MEMORY_KB)) * 1024;
+	uint8_t* found = 0;
+
+	if (ebda) {
+		found = searchLowMemory(ebda, ebda + 1024, signature, checksumLength);
+	}
+
+	if (!found && baseEnd) {
+		found = searchLowMemory(baseEnd - 1024, baseEnd, signature, checksumLength);
+	}
+
+	if (!found) {
+		found = searchLowMemory(BIOS_ROM_START, BIOS_ROM_END, signature, checksumLength);
+	}
+
+	return found;
+}
+
+/**
+ * Map the physical memory starting at physical into the ACPI window and return its virtual address.
+ * Only FIXED_MAP_ACPI_WINDOW_PAGES pages are mapped and each call replaces the last mapping
+ */
+static uint8_t* mapAcpiWindow(MEM_LOC physical) {
+
+	for (unsigned int i = 0; i < FIXED_MAP_ACPI_WINDOW_PAGES; i++) {
+		ia32_map(FIXED_MAP_ACPI_WINDOW + (i * PAGE_SIZE), (physical & PAGE_MASK) + (i * PAGE_SIZE), PAGE_PRESENT);
+	}
+
+	return (uint8_t*) (FIXED_MAP_ACPI_WINDOW + (physical & ~PAGE_MASK));
+}
+
+static void unmapAcpiWindow() {
+
+	for (unsigned int i = 0; i < FIXED_MAP_ACPI_WINDOW_PAGES; i++) {
+		ia32_unmap((POINTER) (FIXED_MAP_ACPI_WINDOW + (i * PAGE_SIZE)));
+	}
+}
+
+/**
+ * Clamp the length of a table to what is visible through the ACPI window
+ */
+static uint32_t windowLength(const uint8_t* table, uint32_t length) {
+	uint32_t available = (FIXED_MAP_ACPI_WINDOW + FIXED_MAP_ACPI_WINDOW_PAGES * PAGE_SIZE) - (MEM_LOC) table;
+	return length < available ? length : available;
+}
+
+static unsigned int discoverFromMadt(MEM_LOC* lapicAddress, unsigned int* apicIds, unsigned int max) {
+
+	uint8_t* rsdp = searchBiosAreas("RSD PTR ", 20);
+
+	if (!rsdp) {
+		return 0;
+	}
+
+	//Copy the table addresses out of the RSDT before the window is reused for each table
+	uint8_t* rsdt = mapAcpiWindow(*((uint32_t*) (rsdp + 16)));
+
+	if (!signatureMatches(rsdt, "RSDT")) {
+		unmapAcpiWindow();
+		return 0;
+	}
+
+	uint32_t tables[RSDT_MAX_ENTRIES];
+	unsigned int numTables = (windowLength(rsdt, *((uint32_t*) (rsdt + 4))) - 36) / sizeof(uint32_t);
+
+	if (numTables > RSDT_MAX_ENTRIES) {
+		numTables = RSDT_MAX_ENTRIES;
+	}
+
+	memcpy(tables, rsdt + 36, numTables * sizeof(uint32_t));
+
+	unsigned int found = 0;
+
+	for (unsigned int i = 0; i < numTables; i++) {
+		uint8_t* madt = mapAcpiWindow(tables[i]);
+
+		if (!signatureMatches(madt, "APIC")) {
+			continue;
+		}
+
+		*lapicAddress = *((uint32_t*) (madt + 36));
+		uint32_t length = windowLength(madt, *((uint32_t*) (madt + 4)));
+
+		//Walk the variable length entries after the header looking for enabled processors
+		for (uint32_t offset = 44; offset + 2 <= length && madt[offset + 1]; offset += madt[offset + 1]) {
+			uint8_t* entry = madt + offset;
+
+			if (entry[0] == MADT_PROCESSOR_ENTRY && (*((uint32_t*) (entry + 4)) & 0x1) && found < max) {
+				apicIds[found++] = entry[3];
+			}
+		}
+
+		break;
+	}
+
+	unmapAcpiWindow();
+	return found;
+}
+
+static unsigned int discoverFromMpTables(MEM_LOC* lapicAddress, unsigned int* apicIds, unsigned int max) {
+
+	uint8_t* floating = searchBiosAreas("_MP_", 16);
+
+	if (!floating) {
+		return 0;
+	}
+
+	MEM_LOC configAddress = *((uint32_t*) (floating + 4));
+
+	//No config table means one of the default configurations, which are all dual processor
+	if (!configAddress) {
+		*lapicAddress = LAPIC_DEFAULT_ADDRESS;
+
+		if (max < 2) {
+			return max;
+		}
+
+		apicIds[0] = 0;
+		apicIds[1] = 1;
+		return 2;
+	}
+
+	uint8_t* config = mapAcpiWindow(configAddress);
+
+	if (!signatureMatches(config, "PCMP")) {
+		unmapAcpiWindow();
+		return 0;
+	}
+
+	*lapicAddress = *((uint32_t*) (config + 0x24));
+
+	uint16_t numEntries = *((uint16_t*) (config + 0x22));
+	uint32_t length = windowLength(config, *((uint16_t*) (config + 4)));
+	uint32_t offset = 44;
+	unsigned int found = 0;
+
+	for (unsigned int i = 0; i < numEntries && offset < length; i++) {
+		uint8_t* entry = config + offset;
+
+		if (entry[0] == MP_PROCESSOR_ENTRY) {
+
+			if ((entry[3] & 0x1) && found < max) {
+				apicIds[found++] = entry[1];
+			}
+
+			offset += MP_PROCESSOR_ENTRY_SIZE;
+		} else {
+			offset += MP_OTHER_ENTRY_SIZE;
+		}
+	}
+
+	unmapAcpiWindow();
+	return found;
+}
+
+unsigned int smpDiscoverProcessors(MEM_LOC* lapicAddress, unsigned int* apicIds, unsigned int max) {
+	unsigned int found = discoverFromMadt(lapicAddress, apicIds, max);
+
+	if (!found) {
+		found = discoverFromMpTables(lapicAddress, apicIds, max);
+	}
+
+	return found;
+}
@@ -0,0 +1,50 @@
+#include <stack/kstack.h>
+#include <stdlib.h>
+#include <types/memory.h>
+#include <lock/spinlock.h>
+
+#define KERNEL_STACK_CACHE_MAX 8
+
+/**
+ * Freed kernel stacks waiting to be reused, linked together through their lowest word
+ */
+static MEM_LOC* stackCache = 0;
+static unsigned int stackCacheSize = 0;
+static spinlock_t stackCacheLock = SPINLOCK_INIT("kernel stack cache");
+
+MEM_LOC kernelStackAllocate() {
+	spinlockAcquire(&stackCacheLock);
+
+	MEM_LOC* stack = stackCache;
+
+	if (stack) {
+		stackCache = (MEM_LOC*) *stack;
+		stackCacheSize--;
+	}
+
+	spinlockRelease(&stackCacheLock);
+
+	if (!stack) {
+		stack = malloc(KERNEL_STACK_SIZE);
+	}
+
+	return (MEM_LOC) stack;
+}
+
+void kernelStackFree(MEM_LOC stack) {
+	spinlockAcquire(&stackCacheLock);
+
+	if (stackCacheSize < KERNEL_STACK_CACHE_MAX) {
+		*((MEM_LOC*) stack) = (MEM_LOC) stackCache;
+		stackCache = (MEM_LOC*) stack;
+		stackCacheSize++;
+		stack = 0;
+	}
+
+	spinlockRelease(&stackCacheLock);
+
+	//The cache is full, give it back to the heap
+	if (stack) {
+		free((void*) stack);
+	}
+}
@@ -8,4 +8,11 @@
 #define USER_STACK_START KERNEL_STACK_START - KERNEL_STACK_SIZE
 #define USER_STACK_SIZE (0x1000 * 100) //400KB stack
 
+/**
+ * Every process has its own KERNEL_STACK_SIZE kernel stack from the kernel heap, the CPU switches to it when the
+ * process is interrupted or makes a syscall in user mode. Freed stacks are cached and handed out again
+ */
+MEM_LOC kernelStackAllocate();
+void kernelStackFree(MEM_LOC stack);
+
 #endif
@@ -1,11 +1,56 @@
 /* This file defines the functions that may be architecture specific related to syscalls - these functions include interrupt callbacks */
 
 #include <syscall/syscall.h>
+#include <syscall/ia32_syscall.h>
 #include <syscall/num.h>
 #include <types/memory.h>
+#include <interrupts/interrupt_handler.h>
+#include <cpu/cpu.h>
+#include <scheduler/scheduler.h>
 #include <printf.h>
+#include <process/accounting.h>
+
+#define MSR_SYSENTER_CS 0x174
+#define MSR_SYSENTER_ESP 0x175
+#define MSR_SYSENTER_EIP 0x176
 
 extern void* syscall_callbacks[];
+extern void sysenter_entry();
+
+typedef MEM_LOC (*syscall_callback_t)(MEM_LOC, MEM_LOC, MEM_LOC, MEM_LOC, MEM_LOC);
+
+static unsigned char fastEntryEnabled = 0;
+
+MEM_LOC syscallDispatch(MEM_LOC number, MEM_LOC p1, MEM_LOC p2, MEM_LOC p3, MEM_LOC p4, MEM_LOC p5) {
+
+	// Firstly, check if the requested syscall number is valid.
+	if (number >= KERNEL_NUM_SYSCALLS || !syscall_callbacks[number]) {
+		return number;
+	}
+
+	// Don't know how many parameters the function wants, so just pass them all.
+	// The caller cleans up the stack so the function will use all the parameters it wants
+	syscall_callback_t callback = (syscall_callback_t) syscall_callbacks[number];
+
+	//The process may be moved to another CPU during the syscall but stays the same process
+	process_t* process = getCurrentProcess();
+
+	//Time up to the outermost syscall is user time, time inside it is kernel time
+	if (!process->syscallDepth) {
+		accountingCharge(process);
+	}
+
+	process->syscallDepth++;
+
+	MEM_LOC result = callback(p1, p2, p3, p4, p5);
+
+	if (process->syscallDepth == 1) {
+		accountingCharge(process);
+	}
+
+	process->syscallDepth--;
+	return result;
+}
 
 //Function: syscallHandler
 //Arguments: idt_call_registers_t regs
@@ -13,42 +58,54 @@ extern void* syscall_callbacks[];
 //Description: Handles a syscall (Via interrupt 127) and returns a new set of registers
 idt_call_registers_t syscallHandler(idt_call_registers_t regs) {
 
-	// Firstly, check if the requested syscall number is valid.
-	// The syscall number is found in EAX.
-	if (regs.eax >= KERNEL_NUM_SYSCALLS) {
-		return regs;
+	// The syscall number is found in EAX and the parameters in EBX, ECX, EDX, ESI and EDI.
+	// The return value goes back in EAX before the interrupt returns (iret instruction) allowing the process that was executing before the syscall to handle it
+	regs.eax = syscallDispatch(regs.eax, regs.ebx, regs.ecx, regs.edx, regs.esi, regs.edi);
+
+	return regs;
+}
+
+/**
+ * sysenter is there if cpuid reports SEP, apart from on the Pentium Pro which reports it without supporting it
+ */
+static unsigned char sysenterSupported() {
+	unsigned long eax, ebx, ecx, edx;
+
+	if (!cpuidHasFeature(CPUID_FEATURE_SEP)) {
+		return 0;
 	}
 
-	// Get the required syscall location.
-	void *location = syscall_callbacks[regs.eax];
-
-	// Don't know how many parameters the function wants, so just
-	// push them all onto the stack in the correct order. The function will
-	// use all the parameters it wants, pop them all back off afterwards.
-	MEM_LOC ret;
-
-	__asm__ volatile (" \
-		   push %1; \
-		   push %2; \
-		   push %3; \
-		   push %4; \
-		   push %5; \
-		   call *%6; \
-		   pop %%ebx; \
-		   pop %%ebx; \
-		   pop %%ebx; \
-		   pop %%ebx; \
-		   pop %%ebx; \
-		" : "=a" (ret) : "r" (regs.edi), "r" (regs.esi), "r" (regs.edx), "r" (regs.ecx), "r" (regs.ebx), "r" (location));
-
-	//Ret the return value of registers_t to ret. Its pushed to eax before the interrupt returns (iret instruction) allowing the process that was executing before the syscall to handle it
-	regs.eax = ret;
+	cpuidQuery(0x1, &eax, &ebx, &ecx, &edx);
 
-	return regs;
+	unsigned long family = (eax >> 8) & 0xF;
+	unsigned long model = (eax >> 4) & 0xF;
+	unsigned long stepping = eax & 0xF;
+
+	return !(family == 6 && model < 3 && stepping < 3);
+}
+
+unsigned char syscallFastEntryAvailable() {
+	return fastEntryEnabled;
+}
+
+void syscallInitializeFastEntry(cpu_t* cpu) {
+
+	if (!fastEntryEnabled) {
+		return;
+	}
+
+	//The stack pointer MSR points at esp0 in the CPUs TSS, sysenter_entry loads the kernel stack of whichever process
+	//is running from there so the MSR doesn't have to be rewritten on every switch
+	cpuWriteMsr(MSR_SYSENTER_CS, 0x08);
+	cpuWriteMsr(MSR_SYSENTER_ESP, (MEM_LOC) &cpu->tss.esp0);
+	cpuWriteMsr(MSR_SYSENTER_EIP, (MEM_LOC) sysenter_entry);
 }
 
 void kernelInitializeSyscallSystem() {
 
 	registerInterruptHandler(127, &syscallHandler); //Syscall = Interrupt 127
+
+	fastEntryEnabled = sysenterSupported();
+	syscallInitializeFastEntry(getCpu());
 	return;
 }
@@ -0,0 +1,17 @@
+#ifndef _IA32_SYSCALL_DEF_H_
+#define _IA32_SYSCALL_DEF_H_
+#include <types/memory.h>
+#include <cpu/percpu.h>
+
+/**
+ * Calls syscall number with the parameters given and returns its result. An invalid number returns the number back,
+ * leaving eax as it was
+ */
+MEM_LOC syscallDispatch(MEM_LOC number, MEM_LOC p1, MEM_LOC p2, MEM_LOC p3, MEM_LOC p4, MEM_LOC p5);
+
+/**
+ * Set up the sysenter MSRs of the CPU (if the fast entry is enabled), every CPU has to call this
+ */
+void syscallInitializeFastEntry(cpu_t* cpu);
+
+#endif //_IA32_SYSCALL_DEF_H_
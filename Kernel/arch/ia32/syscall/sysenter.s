@@ -0,0 +1,53 @@
+[BITS 32]
+[GLOBAL sysenter_entry]
+[EXTERN syscallDispatch]
+
+; Processes enter here through sysenter with the syscall number in eax, the parameters in ebx, ecx, edx, esi and edi
+; and ebp holding their stack pointer. The top of their stack holds the address to return to. The syscall result
+; comes back in eax, ecx and edx are lost
+sysenter_entry:
+   mov esp, [esp]   ; The MSR points at esp0 in this CPU's TSS, the kernel stack of the running process
+
+   push ebp         ; Save the callers stack and segments
+   push ds
+   push es
+   push fs
+   push gs
+
+   mov bp, 0x10     ; load the kernel data segment descriptor
+   mov ds, bp
+   mov es, bp
+   mov fs, bp
+   mov bp, 0x30     ; load the per-CPU data segment
+   mov gs, bp
+
+   sti              ; sysenter disables interrupts, the syscall runs with them on just like through int 127
+
+   push edi
+   push esi
+   push edx
+   push ecx
+   push ebx
+   push eax
+   call syscallDispatch
+   add esp, 24
+
+   cli
+
+   pop gs
+   pop fs
+   pop es
+   pop ds
+   pop ecx          ; sysexit takes the stack pointer in ecx
+   mov edx, ds
+   test dl, 3       ; Processes running in the kernel keep kernel segments, sysexit can only return to user mode
+   mov edx, [ecx]   ; and the return address in edx
+   jz .kernel_caller
+
+   sti              ; The sti only takes effect after sysexit
+   sysexit
+
+.kernel_caller:
+   mov esp, ecx
+   sti
+   jmp edx
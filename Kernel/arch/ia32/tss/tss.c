@@ -1,28 +1,29 @@
 #include "tss.h"
 #include <types/memory.h>
 #include <stack/kstack.h>
+#include <cpu/percpu.h>
 
-tss_entry_t tss_entry;
+extern void gdt_flush(uint32_t);
 
-void writeTss(int num, uint16_t ss0, uint32_t esp0) {
+void writeTss(gdt_entry_t* gdt, int num, tss_entry_t* tss, uint16_t ss0, uint32_t esp0) {
 
    //Generate the base and limit values
-   MEM_LOC base = (MEM_LOC) &tss_entry;
-   MEM_LOC limit = base + sizeof(tss_entry) + 1;
+   MEM_LOC base = (MEM_LOC) tss;
+   MEM_LOC limit = base + sizeof(tss_entry_t) + 1;
 
-   gdtSetGate(num, base, limit, 0xE9, 0x00);
+   gdtSetEntry(gdt, num, base, limit, 0xE9, 0x00);
 
-   memset(&tss_entry, 0, sizeof(tss_entry));
+   memset(tss, 0, sizeof(tss_entry_t));
 
-   tss_entry.ss0  = ss0;  // Set the kernel stack segment.
-   tss_entry.esp0 = esp0; // Set the kernel stack pointer.
+   tss->ss0  = ss0;  // Set the kernel stack segment.
+   tss->esp0 = esp0; // Set the kernel stack pointer.
 
-   tss_entry.cs = 0x0b;
-   tss_entry.ss = tss_entry.ds = tss_entry.es = tss_entry.fs = tss_entry.gs = 0x13;
+   tss->cs = 0x0b;
+   tss->ss = tss->ds = tss->es = tss->fs = tss->gs = 0x13;
 }
 
 void setKernelStack(uint32_t reg) {
-	tss_entry.esp0 = reg;
+	getCpu()->tss.esp0 = reg;
 }
 
 void flushTss() {
@@ -30,8 +31,8 @@ void flushTss() {
 	  ltr %ax;");
 }
 
-void initializeTss() {
-   writeTss(5, 0x10, KERNEL_STACK_START);
-   flushGdt();
+void initializeTss(struct cpuStructure* cpu) {
+   writeTss(cpu->gdt, GDT_TSS_ENTRY, &cpu->tss, 0x10, KERNEL_STACK_START);
+   gdt_flush((uint32_t) &cpu->gdtPtr);
    flushTss();
 }
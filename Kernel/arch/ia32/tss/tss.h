@@ -1,6 +1,9 @@
 #ifndef _TASK_STATE_SEGMENT_
 #define _TASK_STATE_SEGMENT_
 #include <types/stdint.h>
+#include <mm/gdt.h>
+
+struct cpuStructure;
 
 struct tss_entry_struct {
 	uint32_t prev_tss; // The previous TSS - if we used hardware task switching this would form a linked list.
@@ -34,6 +37,14 @@ struct tss_entry_struct {
 
 typedef struct tss_entry_struct tss_entry_t;
 
-void initializeTss();
+/**
+ * Write the TSS of the CPU given into entry GDT_TSS_ENTRY of its GDT, then load its GDT and TSS
+ */
+void initializeTss(struct cpuStructure* cpu);
+
+/**
+ * Set the stack the CPU executing the call switches to when it enters the kernel from user mode
+ */
+void setKernelStack(uint32_t reg);
 
 #endif //_TASK_STATE_SEGMENT_
@@ -1,14 +1,17 @@
 #include <stack/kstack.h>
+#include <tss/tss.h>
+#include <scheduler/scheduler.h>
 
 void switchToUserMode() {
-	setKernelStack(KERNEL_STACK_START);
+	setKernelStack(getCurrentProcess()->kernelStack + KERNEL_STACK_SIZE);
 	__asm__ volatile("  \
 	      	cli; \
 		mov $0x23, %ax; \
 	      	mov %ax, %ds; \
 	      	mov %ax, %es; \
-	      	mov %ax, %fs; \
 	      	mov %ax, %gs; \
+	      	mov $0x3B, %ax; \
+	      	mov %ax, %fs; \
 	                      \
 	      	mov %esp, %eax; \
 	      	pushl $0x23; \
@@ -2,5 +2,6 @@
 #define _POSTBOX_EVENTS_DEFINITIONS_
 
 #define INPUT_BIT 0x1
+#define BROADCAST_BIT 0x2 //Messages sent by processes with postboxBroadcast
 
 #endif //_POSTBOX_EVENTS_DEFINITIONS_
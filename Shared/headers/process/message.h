@@ -10,6 +10,39 @@ typedef struct {
 	long message_data[4]; //4 unsigned ints for data about the message
 
 	MEM_LOC messageAdditionalData; //Additional data sent with the process (Can be used as a pointer)
+
+	unsigned int grantPages; //The number of pages granted with the message, mapped at messageAdditionalData once it is read
+	MEM_LOC grantFrames; //Only used by the kernel while the message is in flight
 } process_message;
 
+/**
+ * Pages granted with messages are mapped into the reader between these addresses
+ */
+#define GRANT_REGION_START 0xA0000000
+#define GRANT_REGION_END 0xB0000000
+
+/**
+ * Errors from sending a message
+ */
+#define POSTBOX_ERROR_NO_PROCESS -1 //There is no process with the PID given
+#define POSTBOX_ERROR_BAD_GRANT -2 //The pages to grant aren't page aligned memory of the sender
+#define POSTBOX_ERROR_FULL -3 //The postbox of the process was full, the message (and any pages granted with it) was dropped
+#define POSTBOX_ERROR_BAD_EVENT -4 //Processes can only broadcast BROADCAST_BIT, the other events are raised by the kernel
+#define POSTBOX_ERROR_THREADED_GRANT -5 //Pages can't be granted while another thread of the sender is running, it could still see them
+
+/**
+ * The number of messages a postbox holds before its policy kicks in, unless the process sets another limit (which
+ * can't go above POSTBOX_MAX_LIMIT)
+ */
+#define POSTBOX_DEFAULT_LIMIT 1024
+#define POSTBOX_MAX_LIMIT 16384
+
+/**
+ * What happens to a message sent to a full postbox. Messages sent from interrupt handlers (input) can't wait, with
+ * POSTBOX_BLOCK_SENDER they are dropped like with POSTBOX_DROP_NEWEST
+ */
+#define POSTBOX_DROP_NEWEST 0 //The message is dropped
+#define POSTBOX_DROP_OLDEST 1 //The oldest message waiting is dropped to make room
+#define POSTBOX_BLOCK_SENDER 2 //The sender sleeps untill there is room
+
 #endif //_PROCESS_MESSAGE_DEF_H_
@@ -0,0 +1,61 @@
+#ifndef _PROCESS_INFO_STRUCTURE_DEF_H_
+#define _PROCESS_INFO_STRUCTURE_DEF_H_
+
+/**
+ * @ingroup Process Info
+ * 
+ * @brief This data structure is used to store information about a process recieved via the syscall API
+ *
+ */
+typedef struct
+{
+	/**
+	  * @ingroup Process Info
+	  * @brief Process ID number
+	  */
+
+	int pID;
+
+	/**
+	  * @ingroup Process Info
+	  * @brief 64 character ASCI string containing the process name
+	  */
+
+	char Name[64];
+
+	/**
+	  * @ingroup Process Info
+	  * @brief unsigned long containing the time in ticks that the processor has spent on this process (Total)
+	  */
+
+	unsigned long processingTime;
+
+	/**
+	  * @ingroup Process Info
+	  * @brief Microseconds the process has spent running outside of and inside of syscalls (0 if they can't be measured)
+	  */
+
+	unsigned long userTime;
+	unsigned long kernelTime;
+
+	/**
+	  * @ingroup Process Info
+	  * @brief Tenths of a percent of a CPU the process has used since it started
+	  */
+
+	unsigned long cpuUsage;
+
+	/**
+	  * @ingroup Process Info
+	  * @brief Messages waiting in the postbox of the process, the most that have waited at once, messages sent to it
+	  * and messages dropped because it was full
+	  */
+
+	unsigned long postboxQueued;
+	unsigned long postboxHighWater;
+	unsigned long postboxEnqueued;
+	unsigned long postboxDropped;
+
+} process_info_t;
+
+#endif //_PROCESS_INFO_STRUCTURE_DEF_H_
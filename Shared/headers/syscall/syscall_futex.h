@@ -0,0 +1,24 @@
+#ifndef _SYSCALL_FUTEX_DEF_H_
+#define _SYSCALL_FUTEX_DEF_H_
+
+/**
+ * A futex is a 32 bit word in memory that threads (or processes sharing the memory) agree on a meaning for. The
+ * kernel knows nothing about the value other than comparing it in futex wait, it only keeps the queue of waiters,
+ * keyed by the physical address of the word. Lock implementations only make the syscalls once they find the word
+ * contended, the uncontended paths are a single atomic instruction in the process
+ */
+
+/**
+ * Results of the futex wait syscall
+ */
+#define FUTEX_WOKEN 0 //Woken by futex wake
+#define FUTEX_VALUE_CHANGED -1 //The word did not hold the expected value, the caller didn't sleep
+#define FUTEX_TIMED_OUT -2 //The timeout ran out before anything woke the caller
+#define FUTEX_BAD_ADDRESS -3 //The word isn't mapped or isn't 4 byte aligned
+
+/**
+ * Passed as the count to futex wake to wake every waiter
+ */
+#define FUTEX_WAKE_ALL 0xFFFFFFFF
+
+#endif //_SYSCALL_FUTEX_DEF_H_
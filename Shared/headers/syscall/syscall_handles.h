@@ -0,0 +1,42 @@
+#ifndef _SYSCALL_HANDLES_DEF_H_
+#define _SYSCALL_HANDLES_DEF_H_
+
+/**
+ * Every process has a table of handles to kernel objects, numbered from 0. The only objects so far are the two ends
+ * of a pipe, a byte stream with a buffer in the kernel. A process writes to one end and whoever holds the other reads
+ * what was written in the same order
+ */
+#define PROCESS_MAX_HANDLES 16
+
+/**
+ * What the process reads input from and writes output to. Anything a process prints goes to its output handle
+ * instead of its terminal while it has one
+ */
+#define HANDLE_STDIN 0
+#define HANDLE_STDOUT 1
+
+/**
+ * Passed instead of a handle to leave it alone
+ */
+#define HANDLE_NONE -1
+
+/**
+ * Flags for creating a pipe: its handles are copied into every process the creator runs
+ */
+#define HANDLE_INHERIT 0x1
+
+/**
+ * Flags for reading and writing: return HANDLE_ERROR_WOULD_BLOCK instead of sleeping
+ */
+#define HANDLE_NONBLOCK 0x1
+
+/**
+ * Errors from the handle syscalls. Reading returns 0 once every write end of a pipe is closed and it is empty
+ */
+#define HANDLE_ERROR_BAD -1 //The handle isn't open (or is the wrong end of the pipe)
+#define HANDLE_ERROR_WOULD_BLOCK -2 //Nothing could be read or written without sleeping
+#define HANDLE_ERROR_CLOSED -3 //Every read end of the pipe is closed, nothing will read what is written
+#define HANDLE_ERROR_TABLE_FULL -4 //The process has no free handles
+#define HANDLE_ERROR_NO_MEMORY -5 //The kernel couldn't allocate a new pipe
+
+#endif //_SYSCALL_HANDLES_DEF_H_
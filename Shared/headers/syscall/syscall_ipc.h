@@ -0,0 +1,27 @@
+#ifndef _SYSCALL_IPC_DEF_H_
+#define _SYSCALL_IPC_DEF_H_
+
+/**
+ * Synchronous IPC is a call from one process to another that blocks untill the other end replies. A server receives
+ * the calls made to it one at a time and replies to each by the PID receive returned. Nothing is queued or allocated,
+ * the message is copied straight into the process at the other end, and the CPU is handed directly between the two
+ * ends of a call so a round trip doesn't have to wait for the scheduler
+ */
+typedef struct {
+
+	/**
+	 * What the message means is up to the processes passing it
+	 */
+	long label;
+	long data[3];
+
+} ipc_message_t;
+
+/**
+ * Errors from the IPC syscalls, call and reply return 0 on success and receive the PID of the caller
+ */
+#define IPC_ERROR_NO_PROCESS -1 //There is no process with the PID given (or it is the caller)
+#define IPC_ERROR_NOT_CALLING -2 //The process given isn't waiting on a reply from the caller
+#define IPC_ERROR_EXITED -3 //The process called exited before replying
+
+#endif //_SYSCALL_IPC_DEF_H_
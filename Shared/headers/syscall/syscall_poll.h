@@ -0,0 +1,44 @@
+#ifndef _SYSCALL_POLL_DEF_H_
+#define _SYSCALL_POLL_DEF_H_
+#include <types/stdint.h>
+
+/**
+ * A process registers the event sources it is interested in with its poll set, then waits on all of them at once.
+ * Readiness is edge triggered: a source is reported once each time it becomes ready (a message arrives, data is
+ * written to a pipe, a timer expires) rather than for as long as it stays ready, so a process should drain whatever
+ * it is told about before waiting again
+ */
+#define POLL_MAX_REGISTRATIONS 32
+
+/**
+ * Sources and what the id registered with them means
+ */
+#define POLL_SOURCE_POSTBOX 0 //The postbox of the process, id is ignored
+#define POLL_SOURCE_HANDLE 1 //id = a handle of the process
+#define POLL_SOURCE_TIMER 2 //id = the number of clock ticks between expiries
+#define POLL_SOURCE_RING 3 //The completions of the syscall ring of the calling thread, id is ignored
+
+/**
+ * Events, registered as the ones to report and reported as the ones that happened
+ */
+#define POLL_READABLE 0x1 //A message arrived in the postbox or something was written to the pipe
+#define POLL_WRITABLE 0x2 //Something was read from the pipe, there is room to write
+#define POLL_HANGUP 0x4 //Every handle on the other end of the pipe was closed
+#define POLL_EXPIRED 0x8 //The timer expired
+#define POLL_COMPLETED 0x10 //Operations on the syscall ring completed
+
+/**
+ * Errors from registering
+ */
+#define POLL_ERROR_BAD -1 //Unknown source, bad handle, timer of 0 ticks or the registration isn't in use
+#define POLL_ERROR_FULL -2 //Every registration is in use
+
+/**
+ * A ready source, userData is whatever it was registered with
+ */
+typedef struct {
+	uint32_t userData;
+	uint32_t events;
+} poll_event_t;
+
+#endif //_SYSCALL_POLL_DEF_H_
@@ -0,0 +1,63 @@
+#ifndef _SYSCALL_RING_DEF_H_
+#define _SYSCALL_RING_DEF_H_
+#include <types/stdint.h>
+#include <types/memory.h>
+
+/**
+ * A syscall ring lets a process queue up a batch of operations and have the kernel carry them all out on a single
+ * syscall (or, in polling mode, on the next tick of the process with no syscall at all).
+ *
+ * The process owns the memory of the ring and registers it with the kernel. It writes operations into submissions and
+ * then moves submissionTail on, the kernel consumes them from submissionHead and writes a completion for each one at
+ * completionTail. The process reads completions from completionHead. All four are free running counters, the slot
+ * used is the counter masked with SYSCALL_RING_MASK
+ */
+#define SYSCALL_RING_ENTRIES 64
+#define SYSCALL_RING_MASK (SYSCALL_RING_ENTRIES - 1)
+
+/**
+ * Set in flags to have the kernel service the ring on every tick the process runs for
+ */
+#define SYSCALL_RING_POLL 0x1
+
+/**
+ * Operations and their parameters. Every operation completes with a result, -1 if the opcode is unknown
+ */
+#define SYSCALL_RING_PRINT 0 //params[0] = const char* string to print to the process terminal. Result 0
+#define SYSCALL_RING_POSTBOX_READ 1 //params[0] = process_message* to copy the top message to, it is removed from the postbox. Result 1 if there was a message, 0 otherwise
+#define SYSCALL_RING_PROCESS_INFO 2 //params[0] = scheduler iterator, params[1] = process_info_t* to fill in. Result 1 if there is a process at the iterator, 0 otherwise
+#define SYSCALL_RING_FILE_READ 3 //params[0] = const char* path (from the execution directory), params[1] = offset, params[2] = size, params[3] = uint8_t* buffer. Result the number of bytes read or -1 if there is no such file
+#define SYSCALL_RING_SLEEP 4 //params[0] = number of ticks to sleep for. Result 0
+
+typedef struct {
+	uint32_t opcode;
+
+	/**
+	 * Copied into the completion of the operation so the process can match them up
+	 */
+	uint32_t userData;
+
+	MEM_LOC params[4];
+} syscall_ring_submission_t;
+
+typedef struct {
+	uint32_t userData;
+	sint32_t result;
+} syscall_ring_completion_t;
+
+typedef struct {
+	volatile uint32_t submissionHead;
+	volatile uint32_t submissionTail;
+	volatile uint32_t completionHead;
+	volatile uint32_t completionTail;
+
+	/**
+	 * SYSCALL_RING_ flags
+	 */
+	volatile uint32_t flags;
+
+	syscall_ring_submission_t submissions[SYSCALL_RING_ENTRIES];
+	syscall_ring_completion_t completions[SYSCALL_RING_ENTRIES];
+} syscall_ring_t;
+
+#endif //_SYSCALL_RING_DEF_H_
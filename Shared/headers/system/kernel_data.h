@@ -0,0 +1,48 @@
+#ifndef _KERNEL_DATA_PAGE_DEF_H_
+#define _KERNEL_DATA_PAGE_DEF_H_
+#include <types/stdint.h>
+
+/**
+ * The kernel data page is mapped read only at KERNEL_DATA_PAGE_ADDRESS in every address space and kept up to date by
+ * the kernel on every clock tick, so processes can read the clock and a few system counters without a syscall.
+ *
+ * Every process also gets its own read only process data page at PROCESS_DATA_PAGE_ADDRESS
+ */
+#define KERNEL_DATA_PAGE_ADDRESS 0xDFFFD000
+#define PROCESS_DATA_PAGE_ADDRESS 0xBFF00000
+
+typedef struct {
+
+	/**
+	 * Odd while the kernel is part way through an update. Readers that need several fields to agree (the TSC ones)
+	 * read it before and after and try again if it was odd or changed
+	 */
+	volatile uint32_t sequence;
+
+	/**
+	 * Clock ticks since boot and the number of them per second
+	 */
+	volatile unsigned long ticks;
+	volatile unsigned long ticksPerSecond;
+
+	/**
+	 * The timestamp counter when the last tick happened and the number of TSC cycles per tick (0 untill it has been
+	 * calibrated or if the CPU has no TSC), for timing below the resolution of a tick
+	 */
+	volatile uint64_t tscAtLastTick;
+	volatile uint64_t tscPerTick;
+
+	/**
+	 * System counters
+	 */
+	volatile uint32_t numProcesses;
+	volatile uint32_t freeFrames;
+	volatile uint32_t onlineCpus;
+} kernel_data_page_t;
+
+typedef struct {
+	volatile uint32_t pid;
+	volatile uint32_t parentPid;
+} process_data_page_t;
+
+#endif //_KERNEL_DATA_PAGE_DEF_H_